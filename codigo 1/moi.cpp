@@ -7,6 +7,12 @@
 #include <iomanip>
 #include <chrono>
 #include <tuple>
+#include <cstdint>
+#include <thread>
+#include <atomic>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -18,6 +24,102 @@ struct Item {
     int valor;
 };
 
+// Indice del bit menos significativo (GCC/Clang y MSVC)
+inline int lowestBit(uint64_t w) {
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward64(&idx, w);
+    return static_cast<int>(idx);
+#else
+    return __builtin_ctzll(w);
+#endif
+}
+
+// Estadisticas en linea de memoria acotada: media y varianza de Welford,
+// minimo, maximo y percentiles de un histograma log-lineal al estilo HDR.
+// Cada valor se cuenta en unidades de `resolution` (1 ns para tiempos);
+// por debajo de 2^8 unidades los cubos son exactos y por encima cada
+// potencia de dos se divide en 128 cubos, asi el error relativo de un
+// percentil es menor que 1/128. El histograma crece solo hasta el mayor
+// cubo usado (unos 3500 cubos para un minuto en ns).
+class RunningStats {
+private:
+    static const int SUB_BITS = 8;
+    static const uint64_t HALF = 1ULL << (SUB_BITS - 1);
+    double resolution;
+    unsigned long long n = 0;
+    double mean_ = 0.0, m2 = 0.0;
+    double min_ = 0.0, max_ = 0.0;
+    std::vector<unsigned long long> buckets;
+
+    static size_t bucketOf(uint64_t ticks) {
+        if (ticks < (1ULL << SUB_BITS)) return static_cast<size_t>(ticks);
+        int msb = 63 - leadingZeros(ticks);
+        int shift = msb - (SUB_BITS - 1);
+        return static_cast<size_t>(shift * HALF + (ticks >> shift));
+    }
+
+    // Punto medio del cubo, en unidades
+    static double bucketValue(size_t idx) {
+        if (idx < (1ULL << SUB_BITS)) return static_cast<double>(idx);
+        uint64_t shift = idx / HALF - 1;
+        uint64_t sub = idx - shift * HALF;
+        return std::ldexp(static_cast<double>(sub), static_cast<int>(shift)) + (std::ldexp(1.0, static_cast<int>(shift)) - 1) / 2;
+    }
+
+    // Ceros a la izquierda de w (w != 0)
+    static int leadingZeros(uint64_t w) {
+#if defined(_MSC_VER)
+        unsigned long idx;
+        _BitScanReverse64(&idx, w);
+        return 63 - static_cast<int>(idx);
+#else
+        return __builtin_clzll(w);
+#endif
+    }
+
+public:
+    explicit RunningStats(double resolution = 1.0) : resolution(resolution) {}
+
+    void add(double x) {
+        n++;
+        double delta = x - mean_;
+        mean_ += delta / n;
+        m2 += delta * (x - mean_);
+        if (n == 1 || x < min_) min_ = x;
+        if (n == 1 || x > max_) max_ = x;
+        double scaled = std::max(0.0, x / resolution);
+        uint64_t ticks = scaled >= 9.2e18 ? (1ULL << 63) : static_cast<uint64_t>(std::llround(scaled));
+        size_t idx = bucketOf(ticks);
+        if (idx >= buckets.size()) buckets.resize(idx + 1, 0);
+        buckets[idx]++;
+    }
+
+    unsigned long long count() const { return n; }
+    double mean() const { return mean_; }
+    // Varianza poblacional (divide por n, como el calculo original)
+    double variance() const { return n ? m2 / n : 0.0; }
+    double stddev() const { return std::sqrt(variance()); }
+    double min() const { return min_; }
+    double max() const { return max_; }
+
+    // Percentil q en [0, 1] (menor valor con al menos q * n muestras <= el)
+    double percentile(double q) const {
+        if (n == 0) return 0.0;
+        unsigned long long rank = static_cast<unsigned long long>(std::ceil(q * n));
+        rank = std::max(1ULL, std::min(rank, n));
+        unsigned long long seen = 0;
+        for (size_t idx = 0; idx < buckets.size(); ++idx) {
+            seen += buckets[idx];
+            if (seen >= rank) {
+                double v = bucketValue(idx) * resolution;
+                return std::min(max_, std::max(min_, v));
+            }
+        }
+        return max_;
+    }
+};
+
 class CuckooSearchKnapsack {
 private:
     std::vector<Item> items;
@@ -162,11 +264,13 @@ public:
                 fitness_values[idx] = fitness(nests[idx]);
             }
 
-            // Actualizar la mejor solución
+            // Actualizar la mejor solución (solo se copia cuando mejora)
             best_idx = std::max_element(fitness_values.begin(), fitness_values.end()) 
                       - fitness_values.begin();
-            best_fitness = fitness_values[best_idx];
-            best_nest = nests[best_idx];
+            if (fitness_values[best_idx] > best_fitness) {
+                best_fitness = fitness_values[best_idx];
+                best_nest = nests[best_idx];
+            }
 
             fitness_evolution.push_back(best_fitness);
         }
@@ -178,40 +282,115 @@ public:
         return {best_nest, fitness_evolution, duration};
     }
 
-    // Algoritmo de fuerza bruta para comparación
-    std::tuple<std::vector<std::vector<int>>, int, std::chrono::duration<double>> bruteForceSolution() {
+    // Algoritmo de fuerza bruta para comparación.
+    // Las 2^n mascaras (64 bits, n <= 63) se recorren en codigo Gray: cada paso
+    // mete o saca un solo item, asi peso y valor se actualizan con una suma o
+    // una resta. El espacio se parte en bloques por los 6 bits altos (con
+    // menos de 6 items, un bloque por mascara) y los bloques se reparten
+    // entre hilos. Con mas de 63 items las mascaras no caben: se avisa y el
+    // valor optimo devuelto es -1. Se cuentan todos los optimos empatados
+    // pero solo se guardan los primeros max_muestras (en orden de bloque, asi
+    // la muestra no depende del numero de hilos).
+    // Retorna: muestra de soluciones optimas, valor optimo, cantidad de optimos, tiempo
+    std::tuple<std::vector<std::vector<int>>, int, unsigned long long, std::chrono::duration<double>>
+    bruteForceSolution(size_t max_muestras = 16, unsigned n_hilos = std::thread::hardware_concurrency()) {
         auto start = std::chrono::high_resolution_clock::now();
-        int n = items.size();
-        int best_value = 0;
-        std::vector<std::vector<int>> best_solutions;
+        const int n = static_cast<int>(items.size());
+        if (n > 63) {
+            std::cerr << "Fuerza bruta: " << n << " items, el maximo es 63" << std::endl;
+            return {{}, -1, 0, std::chrono::duration<double>(0)};
+        }
+
+        // Resultado parcial de un bloque
+        struct Parcial {
+            long long best_value = -1;
+            unsigned long long count = 0;
+            std::vector<uint64_t> muestras;
+
+            void registrar(long long value, uint64_t mask, size_t max_muestras) {
+                if (value > best_value) {
+                    best_value = value;
+                    count = 0;
+                    muestras.clear();
+                }
+                if (value == best_value) {
+                    count++;
+                    if (muestras.size() < max_muestras) muestras.push_back(mask);
+                }
+            }
+        };
 
-        // Generar todas las combinaciones posibles (2^n)
-        for (int mask = 1; mask < (1 << n); ++mask) {
-            int total_weight = 0, total_value = 0;
-            std::vector<int> current_solution(n, 0);
+        const int high_bits = std::min(n, 6);
+        const int low_bits = n - high_bits;
+        const uint64_t n_bloques = 1ULL << high_bits;
+        const uint64_t pasos = 1ULL << low_bits;
+        std::vector<Parcial> parciales(n_bloques);
 
-            for (int i = 0; i < n; ++i) {
-                if (mask & (1 << i)) {
-                    current_solution[i] = 1;
+        auto recorrerBloque = [&](uint64_t bloque) {
+            Parcial& parcial = parciales[bloque];
+            uint64_t mask = bloque << low_bits;
+            long long total_weight = 0, total_value = 0;
+            for (int i = low_bits; i < n; ++i) {
+                if (mask >> i & 1) {
                     total_weight += items[i].peso;
                     total_value += items[i].valor;
                 }
             }
+            for (uint64_t g = 0; g < pasos; ++g) {
+                if (g > 0) {
+                    int i = lowestBit(g);
+                    mask ^= 1ULL << i;
+                    if (mask >> i & 1) {
+                        total_weight += items[i].peso;
+                        total_value += items[i].valor;
+                    } else {
+                        total_weight -= items[i].peso;
+                        total_value -= items[i].valor;
+                    }
+                }
+                if (mask != 0 && total_weight <= capacity) parcial.registrar(total_value, mask, max_muestras);
+            }
+        };
 
-            if (total_weight <= capacity) {
-                if (total_value > best_value) {
-                    best_value = total_value;
-                    best_solutions.clear();
-                    best_solutions.push_back(current_solution);
-                } else if (total_value == best_value) {
-                    best_solutions.push_back(current_solution);
+        // Cada hilo toma el siguiente bloque libre
+        std::atomic<uint64_t> siguiente(0);
+        auto trabajador = [&]() {
+            for (uint64_t bloque = siguiente++; bloque < n_bloques; bloque = siguiente++) recorrerBloque(bloque);
+        };
+        unsigned hilos = static_cast<unsigned>(std::min<uint64_t>(std::max(1u, n_hilos), n_bloques));
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < hilos; ++t) pool.emplace_back(trabajador);
+        trabajador();
+        for (std::thread& t : pool) t.join();
+
+        // Unir los bloques en orden
+        Parcial total;
+        for (const Parcial& parcial : parciales) {
+            if (parcial.best_value < 0) continue;
+            if (parcial.best_value > total.best_value) {
+                total.best_value = parcial.best_value;
+                total.count = 0;
+                total.muestras.clear();
+            }
+            if (parcial.best_value == total.best_value) {
+                total.count += parcial.count;
+                for (uint64_t mask : parcial.muestras) {
+                    if (total.muestras.size() < max_muestras) total.muestras.push_back(mask);
                 }
             }
         }
-        
+
+        std::vector<std::vector<int>> best_solutions;
+        for (uint64_t mask : total.muestras) {
+            std::vector<int> solution(n, 0);
+            for (int i = 0; i < n; ++i) solution[i] = (mask >> i) & 1;
+            best_solutions.push_back(solution);
+        }
+
         auto end = std::chrono::high_resolution_clock::now();
         std::chrono::duration<double> duration = end - start;
-        return {best_solutions, best_value, duration};
+        int best_value = static_cast<int>(std::max(0LL, total.best_value));
+        return {best_solutions, best_value, total.count, duration};
     }
 
     // Mostrar una solución
@@ -299,43 +478,43 @@ int main() {
     
     // Ejecutar fuerza bruta para comparación
     std::cout << "\n=== FUERZA BRUTA (SOLUCIÓN ÓPTIMA) ===" << std::endl;
-    auto [optimal_solutions, optimal_value, duration_bruteforce] = cuckoo.bruteForceSolution();
+    auto [optimal_solutions, optimal_value, optimal_count, duration_bruteforce] = cuckoo.bruteForceSolution();
     // Imprimir fuerza bruta
     std::cout << duration_bruteforce.count() << " segundos" << std::endl;
     std::cout << "Valor óptimo: " << optimal_value << std::endl;
-    std::cout << "NúmerSo de soluciones óptimas encontradas: " << optimal_solutions.size() << std::endl;
-    cuckoo.printSolution(optimal_solutions[0]); 
+    std::cout << "NúmerSo de soluciones óptimas encontradas: " << optimal_count << std::endl;
+    if (optimal_value < 0) return 1;
+    if (!optimal_solutions.empty()) cuckoo.printSolution(optimal_solutions[0]);
+
+    // Calidad del Cuckoo Search: cuantas de las 10 ejecuciones llegaron al óptimo
+    int contador_optimos = 0;
+    for (const auto& solution : all_solutions) {
+        if (cuckoo.fitness(solution) == optimal_value) contador_optimos++;
+    }
+    std::cout << "Ejecuciones de Cuckoo Search que alcanzaron el óptimo (" << optimal_value << "): "
+              << contador_optimos << "/" << all_solutions.size() << std::endl;
     
     
     
-    // Ejecutar fuerza bruta 10,000 veces
-    int contador_optimos = 0;
-    std::vector<double> tiempos_bruteforce;
+    // Ejecutar fuerza bruta 10,000 veces (solo tiempos: el valor es siempre el óptimo)
+    RunningStats tiempos_bruteforce(1e-9);
 
     for (int i = 0; i < 10000; ++i) {
-        auto [optimal_solutions, optimal_value, duration_bruteforce] = cuckoo.bruteForceSolution();
-        tiempos_bruteforce.push_back(duration_bruteforce.count());
-        if (optimal_value == 200) {
-            contador_optimos++;
-        }
+        // Con 10 items un solo hilo es mas rapido que lanzar varios
+        auto [solutions_i, value_i, count_i, duration_i] = cuckoo.bruteForceSolution(1, 1);
+        tiempos_bruteforce.add(duration_i.count());
     }
 
     // Estadísticas
-    double suma_tiempo = std::accumulate(tiempos_bruteforce.begin(), tiempos_bruteforce.end(), 0.0);
-    double promedio_tiempo = suma_tiempo / tiempos_bruteforce.size();
-
-    double varianza = 0.0;
-    for (const auto& t : tiempos_bruteforce) {
-        varianza += (t - promedio_tiempo) * (t - promedio_tiempo);
-    }
-    double std_dev = std::sqrt(varianza / tiempos_bruteforce.size());
+    double promedio_tiempo = tiempos_bruteforce.mean();
+    double std_dev = tiempos_bruteforce.stddev();
 
     // Mostrar resultados
     std::cout << "\n=== RESULTADOS DE 10,000 EJECUCIONES DE FUERZA BRUTA ===\n";
     std::cout << "Tiempo promedio: " << promedio_tiempo << " segundos\n";
     std::cout << "Desviación estándar: " << std_dev << " segundos\n";
-    std::cout << "Cantidad veces que se alcanzó el óptimo (200): " << contador_optimos << "/10000\n";
-    std::cout << "Cantidad veces que NO se alcanzó el óptimo: " << (10000 - contador_optimos) << "/10000\n";
+    std::cout << "p50 / p90 / p99 / max: " << tiempos_bruteforce.percentile(0.50) << " / " << tiempos_bruteforce.percentile(0.90)
+              << " / " << tiempos_bruteforce.percentile(0.99) << " / " << tiempos_bruteforce.max() << " segundos\n";
 
     
 
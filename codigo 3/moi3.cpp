@@ -10,179 +10,3800 @@
 #include <string>
 #include <fstream>
 #include <sstream>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <condition_variable>
+#include <memory>
+#include <queue>
+#include <limits>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <cstring>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-struct Item {
-    int peso;
-    int valor;
+// Operaciones de bits portables (GCC/Clang y MSVC)
+inline int lowestBit(uint64_t w) {
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward64(&idx, w);
+    return static_cast<int>(idx);
+#else
+    return __builtin_ctzll(w);
+#endif
+}
+
+inline int popcount64(uint64_t w) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(w));
+#else
+    return __builtin_popcountll(w);
+#endif
+}
+
+// ===================== Generador basado en contador =====================
+// Philox4x32-10 (Salmon et al., 2011). La salida es una funcion pura de
+// (clave, contador): la clave es la semilla de 64 bits y las dos palabras
+// altas del contador identifican el flujo (linea de config, repeticion).
+// Asi cada flujo es reproducible e independiente del numero de hilos.
+class Philox4x32 {
+public:
+    using result_type = uint32_t;
+
+    Philox4x32() : Philox4x32(0, 0, 0) {}
+    Philox4x32(uint64_t seed, uint32_t stream_hi, uint32_t stream_lo)
+        : Philox4x32(seed, stream_hi, stream_lo, 0) {}
+    // Subflujo: la palabra alta del contador de bloque (2^32 bloques por subflujo)
+    Philox4x32(uint64_t seed, uint32_t stream_hi, uint32_t stream_lo, uint32_t substream)
+        : key{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)},
+          counter{0, substream, stream_lo, stream_hi}, output{0, 0, 0, 0}, next(4) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xffffffffu; }
+
+    result_type operator()() {
+        if (next == 4) {
+            generateBlock();
+            next = 0;
+        }
+        return output[next++];
+    }
+
+private:
+    uint32_t key[2];
+    uint32_t counter[4];
+    uint32_t output[4];
+    int next;
+
+    void generateBlock() {
+        uint32_t c[4] = {counter[0], counter[1], counter[2], counter[3]};
+        uint32_t k0 = key[0], k1 = key[1];
+        for (int round = 0; round < 10; ++round) {
+            uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * c[0];
+            uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * c[2];
+            uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c[1] ^ k0;
+            uint32_t n1 = static_cast<uint32_t>(p1);
+            uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c[3] ^ k1;
+            uint32_t n3 = static_cast<uint32_t>(p0);
+            c[0] = n0; c[1] = n1; c[2] = n2; c[3] = n3;
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        for (int t = 0; t < 4; ++t) output[t] = c[t];
+        // Contador de bloque de 64 bits en las dos palabras bajas
+        if (++counter[0] == 0) ++counter[1];
+    }
 };
 
-class CuckooSearchKnapsack {
+// Flujos reservados dentro de una linea de config
+const uint32_t STREAM_INSTANCE = 0xffffffffu;
+const uint32_t STREAM_ZOBRIST = 0xfffffffeu; // claves Zobrist de la cache de fitness
+
+// Clave derivada para la isla k (k = 0 conserva la semilla)
+inline uint64_t islandKey(uint64_t seed, int island) {
+    return seed ^ (static_cast<uint64_t>(island) * 0x9E3779B97F4A7C15ULL);
+}
+
+// Clave de la generacion g del modo por lotes; el candidato del nido i usa
+// el subflujo i + 1 (el 0 es el de los flujos normales)
+inline uint64_t generationKey(uint64_t seed, int generation) {
+    return seed ^ ((static_cast<uint64_t>(generation) + 1) * 0xD1B54A32D192ED03ULL);
+}
+
+// ===================== Bits aleatorios palabra a palabra =====================
+// xoshiro256** (Blackman y Vigna, 2018): 256 bits de estado y 64 bits por
+// llamada, para rellenar soluciones de 64 en 64 items. Se siembra desde el
+// flujo Philox de la repeticion, asi que hereda su reproducibilidad.
+class Xoshiro256ss {
+public:
+    using result_type = uint64_t;
+
+    Xoshiro256ss() : s{1, 2, 3, 4} {}
+    explicit Xoshiro256ss(Philox4x32& seeder) {
+        // splitmix64 sobre 64 bits del flujo: nunca deja el estado en cero
+        uint64_t x = (static_cast<uint64_t>(seeder()) << 32) | seeder();
+        for (int t = 0; t < 4; ++t) {
+            uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            s[t] = z ^ (z >> 31);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~0ULL; }
+
+    result_type operator()() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
 private:
-    std::vector<Item> items;
-    int capacity;
-    int n_nests;
-    int max_iter;
-    double pa;
-    double alfa;
-    std::mt19937 gen;
+    uint64_t s[4];
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+// Palabra de 64 bits Bernoulli(p): p se redondea a BERNOULLI_BITS bits y se
+// recorre su expansion binaria del bit menos al mas significativo; un 1
+// combina con OR una palabra nueva y un 0 con AND, de modo que cada bit
+// termina con probabilidad exactamente 0.b1b2...bk. p = 0.5 cuesta una
+// sola palabra; los ceros finales de la expansion no cuestan nada.
+const int BERNOULLI_BITS = 16;
+
+class BernoulliWords {
+public:
+    explicit BernoulliWords(double p = 0.5) { setProbability(p); }
+
+    void setProbability(double p) {
+        p = std::min(1.0, std::max(0.0, p));
+        uint32_t q = static_cast<uint32_t>(std::lround(p * (1u << BERNOULLI_BITS)));
+        constant = 0;
+        steps = 0;
+        if (q == 0) return;
+        if (q >= (1u << BERNOULLI_BITS)) {
+            constant = ~0ULL;
+            return;
+        }
+        int low = lowestBit(q);
+        for (int b = low; b < BERNOULLI_BITS; ++b) ops[steps++] = (q >> b) & 1;
+    }
+
+    // Una palabra con cada bit a 1 con probabilidad p
+    uint64_t operator()(Xoshiro256ss& bits) const {
+        if (steps == 0) return constant;
+        uint64_t w = bits(); // el bit menos significativo de la expansion es 1
+        for (int t = 1; t < steps; ++t) w = ops[t] ? (w | bits()) : (w & bits());
+        return w;
+    }
+
+private:
+    uint64_t constant;
+    int steps;
+    uint8_t ops[BERNOULLI_BITS];
+};
+
+// ===================== Kernel de Levy flight por lotes =====================
+// Cada palabra de 64 items consume 192 enteros aleatorios de 32 bits:
+// [0,64) y [64,128) alimentan Box-Muller (u y v de Mantegna salen del coseno
+// y del seno del mismo par) y [128,192) son los uniformes de la decision.
+const int LEVY_RANDOMS_PER_WORD = 192;
+
+// Constantes de Mantegna, calculadas una sola vez por beta
+struct LevyConstants {
+    double beta;
+    double sigma;
+    double neg_inv_beta;
+
+    explicit LevyConstants(double b) : beta(b) {
+        double numerator = std::tgamma(1.0 + beta) * std::sin(M_PI * beta / 2.0);
+        double denominator = std::tgamma((1.0 + beta) / 2.0) * beta * std::pow(2.0, (beta - 1.0) / 2.0);
+        sigma = std::pow(numerator / denominator, 1.0 / beta);
+        neg_inv_beta = -1.0 / beta;
+    }
+};
+
+// Camino escalar: misma secuencia de operaciones que el camino AVX2
+static uint64_t levyWordScalar(const uint32_t* rnd, uint64_t parent, const LevyConstants& k, double alfa) {
+    const double scale = 1.0 / 16777216.0;
+    uint64_t out = 0;
+    for (int b = 0; b < 64; ++b) {
+        double u1 = ((rnd[b] >> 8) + 1.0) * scale;
+        double u2 = (rnd[64 + b] >> 8) * scale;
+        double r = (rnd[128 + b] >> 8) * scale;
+        double rad = std::sqrt(-2.0 * std::log(u1));
+        double theta = 2.0 * M_PI * u2;
+        double u = rad * std::cos(theta) * k.sigma;
+        double v = std::max(std::abs(rad * std::sin(theta)), 1e-30);
+        double levy = u * std::exp(k.neg_inv_beta * std::log(v));
+        double new_value = static_cast<double>((parent >> b) & 1ULL) + alfa * levy;
+        // ADAPTACION: Convertir la nueva solucion de continua a discreta {0,1}
+        double sigmoide = 1.0 / (1.0 + std::exp(-std::abs(new_value)));
+        if (r < sigmoide) out |= 1ULL << b;
+    }
+    return out;
+}
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CSA_AVX2_DISPATCH 1
+#include <immintrin.h>
+
+// Aproximaciones vectoriales (8 floats). Error relativo ~1e-7, suficiente
+// para una decision contra un uniforme de 24 bits.
+__attribute__((target("avx2"))) static inline __m256 log256(__m256 x) {
+    __m256i xi = _mm256_castps_si256(x);
+    __m256i e = _mm256_sub_epi32(_mm256_and_si256(_mm256_srli_epi32(xi, 23), _mm256_set1_epi32(0xff)),
+                                 _mm256_set1_epi32(127));
+    __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(xi, _mm256_set1_epi32(0x007fffff)),
+                                                   _mm256_set1_epi32(0x3f800000)));
+    // Llevar la mantisa a [sqrt(1/2), sqrt(2))
+    __m256 big = _mm256_cmp_ps(m, _mm256_set1_ps(1.41421356f), _CMP_GT_OQ);
+    m = _mm256_blendv_ps(m, _mm256_mul_ps(m, _mm256_set1_ps(0.5f)), big);
+    e = _mm256_add_epi32(e, _mm256_and_si256(_mm256_castps_si256(big), _mm256_set1_epi32(1)));
+    // ln(m) = 2 atanh((m-1)/(m+1))
+    __m256 f = _mm256_div_ps(_mm256_sub_ps(m, _mm256_set1_ps(1.0f)), _mm256_add_ps(m, _mm256_set1_ps(1.0f)));
+    __m256 f2 = _mm256_mul_ps(f, f);
+    __m256 p = _mm256_set1_ps(2.0f / 9.0f);
+    p = _mm256_add_ps(_mm256_mul_ps(p, f2), _mm256_set1_ps(2.0f / 7.0f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, f2), _mm256_set1_ps(2.0f / 5.0f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, f2), _mm256_set1_ps(2.0f / 3.0f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, f2), _mm256_set1_ps(2.0f));
+    return _mm256_add_ps(_mm256_mul_ps(p, f), _mm256_mul_ps(_mm256_cvtepi32_ps(e), _mm256_set1_ps(0.69314718f)));
+}
+
+__attribute__((target("avx2"))) static inline __m256 exp256(__m256 x) {
+    x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-87.0f)), _mm256_set1_ps(88.0f));
+    __m256 n = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(1.44269504f)),
+                               _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 r = _mm256_sub_ps(x, _mm256_mul_ps(n, _mm256_set1_ps(0.693359375f)));
+    r = _mm256_sub_ps(r, _mm256_mul_ps(n, _mm256_set1_ps(-2.12194440e-4f)));
+    __m256 p = _mm256_set1_ps(1.0f / 720.0f);
+    p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(1.0f / 120.0f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(1.0f / 24.0f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(1.0f / 6.0f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(0.5f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(1.0f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(1.0f));
+    __m256i pow2n = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+    return _mm256_mul_ps(p, _mm256_castsi256_ps(pow2n));
+}
+
+// cos y sin de 2*pi*u para u en [0,1): reduccion por cuadrante y Taylor en [0, pi/2)
+__attribute__((target("avx2"))) static inline void sincos2pi256(__m256 u, __m256& s, __m256& c) {
+    __m256 t = _mm256_mul_ps(u, _mm256_set1_ps(4.0f));
+    __m256 qf = _mm256_floor_ps(t);
+    __m256i q = _mm256_cvtps_epi32(qf);
+    __m256 x = _mm256_mul_ps(_mm256_sub_ps(t, qf), _mm256_set1_ps(1.57079633f));
+    __m256 x2 = _mm256_mul_ps(x, x);
+    __m256 ps = _mm256_set1_ps(-1.0f / 39916800.0f);
+    ps = _mm256_add_ps(_mm256_mul_ps(ps, x2), _mm256_set1_ps(1.0f / 362880.0f));
+    ps = _mm256_add_ps(_mm256_mul_ps(ps, x2), _mm256_set1_ps(-1.0f / 5040.0f));
+    ps = _mm256_add_ps(_mm256_mul_ps(ps, x2), _mm256_set1_ps(1.0f / 120.0f));
+    ps = _mm256_add_ps(_mm256_mul_ps(ps, x2), _mm256_set1_ps(-1.0f / 6.0f));
+    ps = _mm256_add_ps(_mm256_mul_ps(ps, x2), _mm256_set1_ps(1.0f));
+    ps = _mm256_mul_ps(ps, x);
+    __m256 pc = _mm256_set1_ps(1.0f / 479001600.0f);
+    pc = _mm256_add_ps(_mm256_mul_ps(pc, x2), _mm256_set1_ps(-1.0f / 3628800.0f));
+    pc = _mm256_add_ps(_mm256_mul_ps(pc, x2), _mm256_set1_ps(1.0f / 40320.0f));
+    pc = _mm256_add_ps(_mm256_mul_ps(pc, x2), _mm256_set1_ps(-1.0f / 720.0f));
+    pc = _mm256_add_ps(_mm256_mul_ps(pc, x2), _mm256_set1_ps(1.0f / 24.0f));
+    pc = _mm256_add_ps(_mm256_mul_ps(pc, x2), _mm256_set1_ps(-0.5f));
+    pc = _mm256_add_ps(_mm256_mul_ps(pc, x2), _mm256_set1_ps(1.0f));
+    // Cuadrantes impares intercambian seno y coseno
+    __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, _mm256_set1_epi32(1)),
+                                                         _mm256_set1_epi32(1)));
+    __m256 cs = _mm256_blendv_ps(pc, ps, swap);
+    __m256 sn = _mm256_blendv_ps(ps, pc, swap);
+    // cos negativo en cuadrantes 1 y 2, sin negativo en 2 y 3
+    __m256i cos_sign = _mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(q, _mm256_set1_epi32(1)),
+                                                          _mm256_set1_epi32(2)), 30);
+    __m256i sin_sign = _mm256_slli_epi32(_mm256_and_si256(q, _mm256_set1_epi32(2)), 30);
+    c = _mm256_xor_ps(cs, _mm256_castsi256_ps(cos_sign));
+    s = _mm256_xor_ps(sn, _mm256_castsi256_ps(sin_sign));
+}
+
+__attribute__((target("avx2")))
+static uint64_t levyWordAvx2(const uint32_t* rnd, uint64_t parent, const LevyConstants& k, double alfa) {
+    const __m256 scale = _mm256_set1_ps(1.0f / 16777216.0f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 sigma = _mm256_set1_ps(static_cast<float>(k.sigma));
+    const __m256 neg_inv_beta = _mm256_set1_ps(static_cast<float>(k.neg_inv_beta));
+    const __m256 alfa_v = _mm256_set1_ps(static_cast<float>(alfa));
+    const __m256i lane_bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    uint64_t out = 0;
+    for (int c = 0; c < 8; ++c) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rnd + 8 * c));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rnd + 64 + 8 * c));
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rnd + 128 + 8 * c));
+        __m256 u1 = _mm256_mul_ps(_mm256_add_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(a, 8)), one), scale);
+        __m256 u2 = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(b, 8)), scale);
+        __m256 r = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(d, 8)), scale);
+
+        // Box-Muller
+        __m256 rad = _mm256_sqrt_ps(_mm256_mul_ps(_mm256_set1_ps(-2.0f), log256(u1)));
+        __m256 sn, cs;
+        sincos2pi256(u2, sn, cs);
+        __m256 u = _mm256_mul_ps(_mm256_mul_ps(rad, cs), sigma);
+        __m256 v = _mm256_max_ps(_mm256_and_ps(_mm256_mul_ps(rad, sn), abs_mask), _mm256_set1_ps(1e-30f));
+
+        // levy = u / |v|^(1/beta)
+        __m256 levy = _mm256_mul_ps(u, exp256(_mm256_mul_ps(neg_inv_beta, log256(v))));
+        __m256i byte = _mm256_set1_epi32(static_cast<int>((parent >> (8 * c)) & 0xff));
+        __m256 bit = _mm256_and_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(byte, lane_bits), lane_bits)),
+                                   one);
+        __m256 new_value = _mm256_add_ps(bit, _mm256_mul_ps(alfa_v, levy));
+        __m256 e = exp256(_mm256_xor_ps(_mm256_and_ps(new_value, abs_mask), _mm256_set1_ps(-0.0f)));
+        __m256 sigmoide = _mm256_div_ps(one, _mm256_add_ps(one, e));
+        uint64_t m = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(r, sigmoide, _CMP_LT_OQ)));
+        out |= m << (8 * c);
+    }
+    return out;
+}
+#endif
+
+// Genera un candidato completo palabra a palabra. El camino AVX2 se elige
+// en tiempo de ejecucion; sin soporte se usa el escalar.
+class LevyKernel {
+private:
+    LevyConstants k;
+    uint64_t (*word_fn)(const uint32_t*, uint64_t, const LevyConstants&, double);
+    uint32_t rnd[LEVY_RANDOMS_PER_WORD] = {};
+
+public:
+    explicit LevyKernel(double beta, bool allow_simd = true) : k(beta), word_fn(levyWordScalar) {
+#ifdef CSA_AVX2_DISPATCH
+        if (allow_simd && __builtin_cpu_supports("avx2")) word_fn = levyWordAvx2;
+#else
+        (void)allow_simd;
+#endif
+    }
+
+    bool usesAvx2() const { return word_fn != levyWordScalar; }
+
+    template <class Engine>
+    void step(const uint64_t* parent, uint64_t* child, size_t n, double alfa, Engine& gen) {
+        const size_t n_words = (n + 63) / 64;
+        for (size_t w = 0; w < n_words; ++w) {
+            // En la ultima palabra solo se sortean los carriles validos
+            size_t valid = std::min<size_t>(64, n - (w << 6));
+            for (size_t t = 0; t < valid; ++t) rnd[t] = static_cast<uint32_t>(gen());
+            for (size_t t = 0; t < valid; ++t) rnd[64 + t] = static_cast<uint32_t>(gen());
+            for (size_t t = 0; t < valid; ++t) rnd[128 + t] = static_cast<uint32_t>(gen());
+            uint64_t bits = word_fn(rnd, parent[w], k, alfa);
+            if (valid < 64) bits &= (1ULL << valid) - 1;
+            child[w] = bits;
+        }
+    }
+};
+
+// ================= Modo disperso: muestreo por saltos geometricos =================
+// Como new_value = bit + alfa*levy, la salida de cada item solo depende de su
+// bit actual: son dos procesos de Bernoulli con tasas fijas q0 = P(1 | bit 0)
+// y q1 = P(1 | bit 1) para un (alfa, beta) dado.
+struct LevyBitRates {
+    double q0;
+    double q1;
+};
+
+// Inversa de la normal estandar (Acklam, error relativo ~1e-9)
+inline double normalQuantile(double p) {
+    static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                               1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                               6.680131188771972e+01, -1.328068155288572e+01};
+    static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                               -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                               3.754408661907416e+00};
+    if (p < 0.02425) {
+        double q = std::sqrt(-2.0 * std::log(p));
+        return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+               ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+    if (p > 1.0 - 0.02425) return -normalQuantile(1.0 - p);
+    double q = p - 0.5, r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+}
+
+// q0 y q1 por cuadratura de punto medio en el espacio de probabilidades de
+// (u, v), tabulado por (alfa, beta): se calcula una vez por valor de alfa.
+inline LevyBitRates levyBitRates(double alfa, double beta) {
+    static std::mutex table_mutex;
+    static std::map<std::pair<double, double>, LevyBitRates> table;
+    std::lock_guard<std::mutex> lock(table_mutex);
+    auto it = table.find({alfa, beta});
+    if (it != table.end()) return it->second;
+
+    const int M = 1024;
+    LevyConstants k(beta);
+    std::vector<double> su(M), sv(M);
+    for (int i = 0; i < M; ++i) {
+        double z = normalQuantile((i + 0.5) / M);
+        su[i] = alfa * k.sigma * z;
+        sv[i] = std::exp(k.neg_inv_beta * std::log(std::abs(z)));
+    }
+    double acc0 = 0.0, acc1 = 0.0;
+    for (int i = 0; i < M; ++i) {
+        for (int j = 0; j < M; ++j) {
+            double step = su[i] * sv[j];
+            acc0 += 1.0 / (1.0 + std::exp(-std::abs(step)));
+            acc1 += 1.0 / (1.0 + std::exp(-std::abs(1.0 + step)));
+        }
+    }
+    LevyBitRates rates{acc0 / (double(M) * M), acc1 / (double(M) * M)};
+    table[{alfa, beta}] = rates;
+    return rates;
+}
+
+// Construye el hijo partiendo del resultado mas probable de cada bit y
+// elige por saltos geometricos solo los items que se desvian de el.
+// Coste O(n * max(min(q0,1-q0), min(q1,1-q1))) en vez de O(n) normales.
+class SparseLevySampler {
+private:
+    uint64_t base0; // salida mas probable para bits en 0 (todo unos o todo ceros)
+    uint64_t base1;
+    double r0;      // probabilidad de desviarse de base0 / base1
+    double r1;
+    double rmax;
+    double inv_log_keep; // 1 / ln(1 - rmax)
     std::uniform_real_distribution<> dis;
-    std::uniform_int_distribution<> binary_dis;
-    std::normal_distribution<> normal_dis;
 
 public:
-    CuckooSearchKnapsack(const std::vector<Item>& items, int cap, int nests, int iterations, double prob_abandon, double a)
-        : items(items), capacity(cap), n_nests(nests), max_iter(iterations), pa(prob_abandon), alfa(a),
-          gen(std::random_device{}()), dis(0.0, 1.0), binary_dis(0, 1), normal_dis(0.0, 1.0) {}
+    SparseLevySampler(double alfa, double beta) : dis(0.0, 1.0) {
+        LevyBitRates q = levyBitRates(alfa, beta);
+        base0 = (q.q0 >= 0.5) ? ~0ULL : 0ULL;
+        base1 = (q.q1 >= 0.5) ? ~0ULL : 0ULL;
+        r0 = std::min(q.q0, 1.0 - q.q0);
+        r1 = std::min(q.q1, 1.0 - q.q1);
+        rmax = std::max(r0, r1);
+        inv_log_keep = (rmax > 0.0) ? 1.0 / std::log1p(-rmax) : 0.0;
+    }
 
-    int fitness(const std::vector<int>& solution) {
-        int total_weight = 0, total_value = 0;
-        for (size_t i = 0; i < solution.size(); ++i) {
-            if (solution[i] == 1) {
-                total_weight += items[i].peso;
-                total_value += items[i].valor;
+    template <class Engine>
+    void step(const uint64_t* parent, uint64_t* child, size_t n, Engine& gen) {
+        const size_t n_words = (n + 63) / 64;
+        for (size_t w = 0; w < n_words; ++w) {
+            child[w] = (parent[w] & base1) | (~parent[w] & base0);
+        }
+        if (rmax > 0.0) {
+            // Un solo proceso a tasa rmax, adelgazado segun el bit del padre
+            double pos = std::floor(std::log(1.0 - dis(gen)) * inv_log_keep);
+            while (pos < static_cast<double>(n)) {
+                size_t i = static_cast<size_t>(pos);
+                double rate = ((parent[i >> 6] >> (i & 63)) & 1ULL) ? r1 : r0;
+                if (rate >= rmax || dis(gen) * rmax < rate) child[i >> 6] ^= 1ULL << (i & 63);
+                pos += 1.0 + std::floor(std::log(1.0 - dis(gen)) * inv_log_keep);
             }
         }
-        return (total_weight > capacity) ? 0 : total_value;
+        size_t tail = n & 63;
+        if (tail) child[n_words - 1] &= (1ULL << tail) - 1;
     }
+};
 
-    std::vector<int> generateRandomSolution() {
-        std::vector<int> nest(items.size());
-        for (size_t i = 0; i < items.size(); ++i) {
-            nest[i] = binary_dis(gen);
+// ===================== Almacen de items =====================
+
+// Restricciones maximas para la suma enmascarada (las sumas de una palabra van en la pila)
+const int MASKED_MAX_DIMS = 16;
+// Items de una instancia en estructura de arreglos: un arreglo de valores y
+// uno de pesos por restriccion (D filas, D = 1 es la mochila clasica), con
+// una capacidad por restriccion. Las filas se rellenan con ceros hasta un
+// multiplo de 64 items, asi cada palabra de la solucion cubre 64 enteros
+// seguidos de cada fila. Se construye una vez y se comparte inmutable
+// (shared_ptr<const ItemStore>) entre el solver, sus hilos y los solvers
+// exactos. Los totales son de 64 bits.
+#ifdef CSA_AVX2_DISPATCH
+// sums[r] += suma de rows[r][base + t] para cada bit t activo de `bits`. Las
+// 8 mascaras de 8 carriles se construyen una vez (AND con 1 << t y
+// comparacion) y se aplican a todas las filas; la suma de una palabra cabe
+// en int32 porque el almacen solo usa este camino con |x| < 2^25.
+__attribute__((target("avx2"))) static void maskedWordSumsAvx2(const int* const* rows, int count, size_t base,
+                                                               uint64_t bits, long long* sums) {
+    const __m256i lane_bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    __m256i masks[8];
+    for (int k = 0; k < 8; ++k) {
+        __m256i byte = _mm256_set1_epi32(static_cast<int>((bits >> (8 * k)) & 0xff));
+        masks[k] = _mm256_cmpeq_epi32(_mm256_and_si256(byte, lane_bits), lane_bits);
+    }
+    for (int r = 0; r < count; ++r) {
+        const int* x = rows[r] + base;
+        __m256i acc = _mm256_setzero_si256();
+        for (int k = 0; k < 8; ++k) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + 8 * k));
+            acc = _mm256_add_epi32(acc, _mm256_and_si256(v, masks[k]));
         }
-        return nest;
+        __m128i s = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4e));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xb1));
+        sums[r] += _mm_cvtsi128_si32(s);
     }
+}
+#endif
 
-    std::vector<int> levyFlight(const std::vector<int>& current_solution) {
-        // Formular Levy Flight
-        double beta = 1.5;
-        double numerator = std::tgamma(1.0 + beta) * std::sin(M_PI * beta / 2.0);
-        double denominator = std::tgamma((1.0 + beta) / 2.0) * beta * std::pow(2.0, (beta - 1.0) / 2.0);
-        double sigma = std::pow(numerator / denominator, 1.0 / beta);
-        
-        // Construir nueva solucion
-        std::vector<int> new_solution(current_solution.size());
-        for (size_t i = 0; i < current_solution.size(); ++i) {
-            double u = normal_dis(gen) * sigma;
-            double v = normal_dis(gen);
-            double levy = u / std::pow(std::abs(v), 1.0 / beta);
-            double new_value = current_solution[i] + alfa * levy;
-            // ADAPTACION: Convertir la nueva solucion de continua a discreta {0,1}
-            double sigmoide = 1.0 / (1.0 + std::exp(-std::abs(new_value)));
-            double r = dis(gen);
-            new_solution[i] = (r < sigmoide) ? 1 : 0;
-        }
-        
-        return new_solution;
-    }
-
-    std::tuple<int, double, double> repeatedRuns(int repetitions) {
-        std::vector<double> durations;
-        int best_value = 0;
-
-        for (int rep = 0; rep < repetitions; ++rep) {
-            auto start = std::chrono::high_resolution_clock::now();
-
-            std::vector<std::vector<int>> nests(n_nests);
-            std::vector<int> fitness_values(n_nests);
-            for (int i = 0; i < n_nests; ++i) {
-                nests[i] = generateRandomSolution();
-                fitness_values[i] = fitness(nests[i]);
-            }
-
-            int best_idx = std::max_element(fitness_values.begin(), fitness_values.end()) - fitness_values.begin();
-            std::vector<int> best_nest = nests[best_idx];
-            int best_fitness = fitness_values[best_idx];
+class ItemStore {
+private:
+    size_t n;
+    size_t padded; // n redondeado a 64
+    int dims;
+    std::vector<int> item_values;          // padded
+    std::vector<int> item_weights;         // dims filas de padded
+    std::vector<const int*> rows;          // valores y despues cada fila de pesos
+    std::vector<long long> capacities;     // una por restriccion
+    std::vector<long long> word_values;    // suma por palabra de 64 items
+    std::vector<long long> word_weights;   // por palabra, dims cada una
+    bool masked;                           // sumas enmascaradas AVX2 disponibles
 
-            int iteration = 0;
-            while (iteration < max_iter) {
-                std::uniform_int_distribution<> nest_dis(0, n_nests - 1);
-                int i = nest_dis(gen);
-                std::vector<int> new_nest = levyFlight(nests[i]);
-                int new_fitness = fitness(new_nest);
-                int j;
-                do {
-                    j = nest_dis(gen);
-                } while (j == i);
+    void linkRows() {
+        rows[0] = item_values.data();
+        for (int d = 0; d < dims; ++d) rows[d + 1] = item_weights.data() + d * padded;
+    }
 
-                if (new_fitness > fitness_values[j]) {
-                    nests[j] = new_nest;
-                    fitness_values[j] = new_fitness;
-                }
+    // Sumas por palabra y eleccion del camino enmascarado
+    void summarize() {
+        long long largest = 0;
+        for (size_t i = 0; i < n; ++i) {
+            word_values[i >> 6] += item_values[i];
+            largest = std::max<long long>(largest, std::llabs(item_values[i]));
+            for (int d = 0; d < dims; ++d) {
+                word_weights[(i >> 6) * dims + d] += weight(i, d);
+                largest = std::max<long long>(largest, std::llabs(weight(i, d)));
+            }
+        }
+#ifdef CSA_AVX2_DISPATCH
+        masked = __builtin_cpu_supports("avx2") && largest < (1LL << 25) && dims <= MASKED_MAX_DIMS;
+#else
+        (void)largest;
+#endif
+    }
 
-                int new_best_idx = std::max_element(fitness_values.begin(), fitness_values.end()) - fitness_values.begin();
-                int new_best_fitness = fitness_values[new_best_idx];
-                if (new_best_fitness > best_fitness) {
-                    best_fitness = new_best_fitness;
-                    best_nest = nests[new_best_idx];
-                }
+public:
+    // `weights` tiene D filas de n pesos seguidas (la restriccion d empieza en d * n)
+    ItemStore(std::vector<int> values, const std::vector<int>& weights, std::vector<long long> caps)
+        : n(values.size()), padded((values.size() + 63) / 64 * 64), dims(static_cast<int>(caps.size())),
+          item_values(std::move(values)), item_weights(padded * dims, 0), rows(dims + 1),
+          capacities(std::move(caps)), word_values(padded / 64, 0), word_weights(padded / 64 * dims, 0), masked(false) {
+        item_values.resize(padded, 0);
+        linkRows();
+        for (int d = 0; d < dims; ++d) {
+            std::copy(weights.begin() + d * n, weights.begin() + (d + 1) * n, item_weights.begin() + d * padded);
+        }
+        summarize();
+    }
 
-                int num_replacements = static_cast<int>(pa * n_nests);
-                std::vector<int> indices(n_nests);
-                std::iota(indices.begin(), indices.end(), 0);
-                std::sort(indices.begin(), indices.end(), [&](int a, int b) { return fitness_values[a] < fitness_values[b]; });
-                for (int k = 0; k < num_replacements; ++k) {
-                    int idx = indices[k];
-                    nests[idx] = generateRandomSolution();
-                    fitness_values[idx] = fitness(nests[idx]);
-                }
+    // Llena las filas en el sitio, sin copia intermedia: `next(value, weights)`
+    // escribe el item siguiente (su valor y sus D pesos) y la capacidad de la
+    // restriccion d es `capacity(d, suma de los pesos de la fila d)`
+    template <typename Source, typename Capacity>
+    ItemStore(size_t count, int dimensions, Source&& next, Capacity&& capacity)
+        : n(count), padded((count + 63) / 64 * 64), dims(dimensions), item_values(padded, 0),
+          item_weights(padded * dims, 0), rows(dims + 1), capacities(dims), word_values(padded / 64, 0),
+          word_weights(padded / 64 * dims, 0), masked(false) {
+        linkRows();
+        std::vector<int> item(dims);
+        for (size_t i = 0; i < n; ++i) {
+            next(item_values[i], item.data());
+            for (int d = 0; d < dims; ++d) item_weights[d * padded + i] = item[d];
+        }
+        summarize();
+        for (int d = 0; d < dims; ++d) {
+            long long total = 0;
+            for (size_t w = 0; w < padded / 64; ++w) total += word_weights[w * dims + d];
+            capacities[d] = capacity(d, total);
+        }
+    }
+
+    size_t size() const { return n; }
+    int dimensions() const { return dims; }
+    size_t wordCount() const { return padded / 64; }
+    int value(size_t i) const { return item_values[i]; }
+    int weight(size_t i, int d = 0) const { return item_weights[d * padded + i]; }
+    const int* values() const { return item_values.data(); }
+    const int* weights(int d) const { return rows[d + 1]; }
+    const int* const* weightRows() const { return rows.data() + 1; }
+    long long capacity(int d = 0) const { return capacities[d]; }
+    long long wordValue(size_t w) const { return word_values[w]; }
+    const long long* wordWeights(size_t w) const { return word_weights.data() + w * dims; }
+
+    // Hay sumas enmascaradas de palabra completa (AVX2 y valores pequenos)
+    bool maskedSums() const { return masked; }
+
+    // Suma los items activos de la palabra w: sums[0] es el valor y
+    // sums[1 + d] el peso de la restriccion d. Una mascara por grupo de 8
+    // items sirve para todas las filas.
+    void addMaskedWord(size_t w, uint64_t bits, long long* sums) const {
+#ifdef CSA_AVX2_DISPATCH
+        maskedWordSumsAvx2(rows.data(), dims + 1, w << 6, bits, sums);
+#else
+        (void)w, (void)bits, (void)sums;
+#endif
+    }
+
+    // Se cumplen las D restricciones (una pasada sin saltos, vectorizable)
+    bool fits(const long long* totals) const {
+        bool ok = true;
+        for (int d = 0; d < dims; ++d) ok &= (totals[d] <= capacities[d]);
+        return ok;
+    }
+    // Caben ademas `extra` (D pesos seguidos) en todas las restricciones
+    bool fitsWith(const long long* totals, const int* extra) const {
+        bool ok = true;
+        for (int d = 0; d < dims; ++d) ok &= (totals[d] + extra[d] <= capacities[d]);
+        return ok;
+    }
+    // Cabe ademas el item i en todas las restricciones
+    bool fitsItem(const long long* totals, size_t i) const {
+        bool ok = true;
+        for (int d = 0; d < dims; ++d) ok &= (totals[d] + item_weights[d * padded + i] <= capacities[d]);
+        return ok;
+    }
+};
+
+// ===================== Contador de reservas de memoria =====================
+// Reemplaza la familia completa de operator new/delete globales (simples,
+// de arreglo, nothrow y alineados) para poder comprobar que el bucle
+// principal no reserva memoria una vez calentado: toda reserva pasa por el
+// contador y cada liberacion va al mismo asignador que la reservo. Es por
+// hilo, asi cada ejecucion mide solo sus propias reservas.
+static thread_local unsigned long long heap_allocations = 0;
+
+// Sin inlining: GCC confunde new/malloc con delete/free al mezclarlos (-Wmismatched-new-delete)
+#if defined(__GNUC__)
+#define CSA_NOINLINE __attribute__((noinline))
+#else
+#define CSA_NOINLINE
+#endif
+
+inline void* countedMalloc(size_t size) noexcept {
+    ++heap_allocations;
+    return std::malloc(size ? size : 1);
+}
+
+inline void* countedAlignedMalloc(size_t size, std::align_val_t align) noexcept {
+    ++heap_allocations;
+    const size_t a = static_cast<size_t>(align);
+#if defined(_MSC_VER)
+    return _aligned_malloc(size ? size : 1, a);
+#else
+    // aligned_alloc pide un tamano multiplo de la alineacion
+    return std::aligned_alloc(a, (size + a - 1) / a * a + (size ? 0 : a));
+#endif
+}
+
+inline void alignedFree(void* p) noexcept {
+#if defined(_MSC_VER)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+CSA_NOINLINE void* operator new(size_t size) {
+    if (void* p = countedMalloc(size)) return p;
+    throw std::bad_alloc();
+}
+CSA_NOINLINE void* operator new[](size_t size) {
+    if (void* p = countedMalloc(size)) return p;
+    throw std::bad_alloc();
+}
+CSA_NOINLINE void* operator new(size_t size, const std::nothrow_t&) noexcept { return countedMalloc(size); }
+CSA_NOINLINE void* operator new[](size_t size, const std::nothrow_t&) noexcept { return countedMalloc(size); }
+CSA_NOINLINE void* operator new(size_t size, std::align_val_t align) {
+    if (void* p = countedAlignedMalloc(size, align)) return p;
+    throw std::bad_alloc();
+}
+CSA_NOINLINE void* operator new[](size_t size, std::align_val_t align) {
+    if (void* p = countedAlignedMalloc(size, align)) return p;
+    throw std::bad_alloc();
+}
+CSA_NOINLINE void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return countedAlignedMalloc(size, align);
+}
+CSA_NOINLINE void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return countedAlignedMalloc(size, align);
+}
+
+CSA_NOINLINE void operator delete(void* p) noexcept { std::free(p); }
+CSA_NOINLINE void operator delete[](void* p) noexcept { std::free(p); }
+CSA_NOINLINE void operator delete(void* p, size_t) noexcept { std::free(p); }
+CSA_NOINLINE void operator delete[](void* p, size_t) noexcept { std::free(p); }
+CSA_NOINLINE void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+CSA_NOINLINE void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+CSA_NOINLINE void operator delete(void* p, std::align_val_t) noexcept { alignedFree(p); }
+CSA_NOINLINE void operator delete[](void* p, std::align_val_t) noexcept { alignedFree(p); }
+CSA_NOINLINE void operator delete(void* p, size_t, std::align_val_t) noexcept { alignedFree(p); }
+CSA_NOINLINE void operator delete[](void* p, size_t, std::align_val_t) noexcept { alignedFree(p); }
+CSA_NOINLINE void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(p); }
+CSA_NOINLINE void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(p); }
+
+// ===================== Ranking de nidos =====================
+// Arbol de torneo indexado sobre los fitness: cada nodo guarda el indice del
+// minimo y del maximo de su rango. Actualizar un nido cuesta O(log n_nests);
+// el mejor esta en la raiz y los k peores se extraen en O(k log n_nests)
+// excluyendolos temporalmente del minimo. Empates: gana el indice menor.
+class NestRanking {
+private:
+    int n;
+    int leaves;
+    const long long* fitness;
+    std::vector<int> min_idx;
+    std::vector<int> max_idx;
+    std::vector<char> excluded;
+
+    int pickMin(int a, int b) const {
+        if (a < 0 || excluded[a]) return (b < 0 || excluded[b]) ? -1 : b;
+        if (b < 0 || excluded[b]) return a;
+        return (fitness[b] < fitness[a]) ? b : a;
+    }
+    int pickMax(int a, int b) const {
+        if (a < 0) return b;
+        if (b < 0) return a;
+        return (fitness[b] > fitness[a]) ? b : a;
+    }
+    void pull(int node) {
+        min_idx[node] = pickMin(min_idx[2 * node], min_idx[2 * node + 1]);
+        max_idx[node] = pickMax(max_idx[2 * node], max_idx[2 * node + 1]);
+    }
+
+public:
+    NestRanking() : n(0), leaves(0), fitness(nullptr) {}
+
+    void build(const std::vector<long long>& values) {
+        n = static_cast<int>(values.size());
+        fitness = values.data();
+        leaves = 1;
+        while (leaves < n) leaves <<= 1;
+        min_idx.assign(2 * leaves, -1);
+        max_idx.assign(2 * leaves, -1);
+        excluded.assign(n, 0);
+        for (int i = 0; i < n; ++i) min_idx[leaves + i] = max_idx[leaves + i] = i;
+        for (int node = leaves - 1; node >= 1; --node) pull(node);
+    }
+
+    // Llamar cada vez que cambia el fitness (o la exclusion) del nido i
+    void update(int i) {
+        for (int node = (leaves + i) >> 1; node >= 1; node >>= 1) pull(node);
+    }
+
+    int best() const { return max_idx[1]; }
+
+    // Escribe en `out` los k nidos de menor fitness (distintos) y los deja
+    // excluidos hasta que se llame a release() con cada uno
+    void worst(int k, std::vector<int>& out) {
+        out.clear();
+        for (int t = 0; t < k && min_idx[1] >= 0; ++t) {
+            int idx = min_idx[1];
+            out.push_back(idx);
+            excluded[idx] = 1;
+            update(idx);
+        }
+    }
+
+    void release(int i) {
+        excluded[i] = 0;
+        update(i);
+    }
+};
+
+// ===================== Arena de poblacion =====================
+// Todos los nidos viven en un unico bloque contiguo de (n_nests + 2) filas de
+// `stride` palabras: una fila por nido, una fila libre para el candidato de
+// Levy y una fila para el mejor nido. Los nidos se referencian por fila, asi
+// aceptar un candidato es intercambiar indices (doble buffer) y no copiar.
+// La arena se reutiliza entre iteraciones y entre repeticiones. Cada fila es
+// una solucion empaquetada, 64 items por palabra; invariante: los bits
+// sobrantes de la ultima palabra siempre valen 0.
+class PopulationArena {
+private:
+    size_t stride;
+    int n_nests;
+    int dims;
+    std::vector<uint64_t> words;
+    std::vector<int> row_of;             // nido -> fila
+    std::vector<long long> row_weight;   // totales acumulados por fila (dims cada una)
+    std::vector<long long> row_value;
+    std::vector<uint64_t> row_hash;      // hash Zobrist por fila (solo con cache de fitness)
+    std::vector<int> candidate_rows;     // filas libres para candidatos
+    int best_row;
+
+public:
+    std::vector<long long> fitness_values; // fitness por nido
+    std::vector<long long> candidate_fitness; // fitness por candidato (modo por lotes)
+    std::vector<int> order;          // nidos elegidos para el reemplazo
+    std::vector<int> ranked;         // indices ordenados por fitness (emigrantes)
+    NestRanking ranking;
+
+    PopulationArena() : stride(0), n_nests(0), dims(1), best_row(0) {}
+
+    // Solo reserva si la forma crece; en otro caso reutiliza la memoria.
+    // `candidates` filas libres: 1, o una por nido en el modo por lotes.
+    void reset(int nests, size_t n_items, int dimensions, int candidates = 1) {
+        stride = (n_items + 63) / 64;
+        n_nests = nests;
+        dims = dimensions;
+        size_t rows = static_cast<size_t>(nests) + candidates + 1;
+        words.assign(rows * stride, 0);
+        row_of.resize(nests);
+        row_weight.assign(rows * dims, 0);
+        row_value.assign(rows, 0);
+        row_hash.assign(rows, 0);
+        fitness_values.assign(nests, 0);
+        order.reserve(nests);
+        ranked.resize(nests);
+        for (int i = 0; i < nests; ++i) row_of[i] = i;
+        candidate_rows.resize(candidates);
+        for (int c = 0; c < candidates; ++c) candidate_rows[c] = nests + c;
+        candidate_fitness.assign(candidates, 0);
+        best_row = nests + candidates;
+    }
+
+    size_t wordsPerRow() const { return stride; }
+    uint64_t* nest(int i) { return words.data() + row_of[i] * stride; }
+    uint64_t* candidate(int c = 0) { return words.data() + candidate_rows[c] * stride; }
+    const uint64_t* best() const { return words.data() + best_row * stride; }
+
+    long long* weight(int i) { return row_weight.data() + static_cast<size_t>(row_of[i]) * dims; }
+    long long& value(int i) { return row_value[row_of[i]]; }
+    long long* candidateWeight(int c = 0) { return row_weight.data() + static_cast<size_t>(candidate_rows[c]) * dims; }
+    long long& candidateValue(int c = 0) { return row_value[candidate_rows[c]]; }
+    uint64_t& hash(int i) { return row_hash[row_of[i]]; }
+    uint64_t& candidateHash(int c = 0) { return row_hash[candidate_rows[c]]; }
+
+    // El candidato c pasa a ser el nido j; la fila antigua de j queda libre
+    void acceptCandidate(int j, int c = 0) { std::swap(row_of[j], candidate_rows[c]); }
+
+    // Copia solo cuando hay mejora
+    void saveBest(int i) {
+        std::copy(nest(i), nest(i) + stride, words.data() + best_row * stride);
+        std::copy(weight(i), weight(i) + dims, row_weight.data() + static_cast<size_t>(best_row) * dims);
+        row_value[best_row] = value(i);
+    }
+};
+
+// Cache de fitness de tamano fijo con direccionamiento abierto, indexada por
+// el hash Zobrist de la solucion. Cada entrada guarda el hash completo (0 es
+// una entrada vacia) y el fitness; se prueban FITNESS_CACHE_PROBES posiciones
+// seguidas y, si estan todas ocupadas por otras soluciones, se sobrescribe la
+// primera, asi la memoria queda fija en 2^bits entradas de 16 bytes. Dos
+// soluciones distintas comparten hash con probabilidad ~2^-64.
+const int FITNESS_CACHE_PROBES = 4;
+const int FITNESS_CACHE_MAX_BITS = 30;
+
+class FitnessCache {
+private:
+    struct Entry {
+        uint64_t key;
+        long long fitness;
+    };
+    std::vector<Entry> slots;
+    size_t mask;
+
+public:
+    FitnessCache() : mask(0) {}
+
+    // 2^bits entradas vacias (0: sin cache)
+    void reset(int bits) {
+        bits = std::min(bits, FITNESS_CACHE_MAX_BITS);
+        slots.assign(bits > 0 ? size_t(1) << bits : 0, Entry{0, 0});
+        mask = slots.empty() ? 0 : slots.size() - 1;
+    }
+
+    bool enabled() const { return !slots.empty(); }
 
-                iteration++;
+    bool find(uint64_t key, long long& fitness) const {
+        for (int p = 0; p < FITNESS_CACHE_PROBES; ++p) {
+            const Entry& e = slots[(key + p) & mask];
+            if (e.key == key) {
+                fitness = e.fitness;
+                return true;
             }
+            if (e.key == 0) return false;
+        }
+        return false;
+    }
+
+    void insert(uint64_t key, long long fitness) {
+        for (int p = 0; p < FITNESS_CACHE_PROBES; ++p) {
+            Entry& e = slots[(key + p) & mask];
+            if (e.key == 0 || e.key == key) {
+                e = Entry{key, fitness};
+                return;
+            }
+        }
+        slots[key & mask] = Entry{key, fitness};
+    }
+};
+
+// ===================== Pool de hilos con robo de trabajo =====================
+// Pool de tamano fijo con una cola doble por hilo. Cada tarea recibe el
+// indice del hilo que la ejecuta, asi puede usar el estado propio de ese hilo
+// (arena, RNG) sin bloqueos. El dueno toma tareas por delante de su cola; un
+// hilo ocioso roba por detras de la cola de otro. Las tareas enviadas desde
+// fuera se reparten por turnos, de modo que si se envian de mayor a menor
+// coste cada hilo empieza por las mas pesadas.
+class ThreadPool {
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void(int)>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable task_ready;
+    std::condition_variable all_done;
+    size_t queued;   // tareas en alguna cola
+    size_t pending;  // tareas enviadas y no terminadas
+    size_t next_queue;
+    bool stopping;
+
+    bool popOwn(int worker, std::function<void(int)>& task) {
+        WorkerQueue& q = *queues[worker];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) return false;
+        task = std::move(q.tasks.front());
+        q.tasks.pop_front();
+        return true;
+    }
+
+    bool steal(int worker, std::function<void(int)>& task) {
+        const int n = static_cast<int>(queues.size());
+        for (int k = 1; k < n; ++k) {
+            WorkerQueue& q = *queues[(worker + k) % n];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.tasks.empty()) continue;
+            task = std::move(q.tasks.back());
+            q.tasks.pop_back();
+            return true;
+        }
+        return false;
+    }
+
+    void workerLoop(int worker) {
+        for (;;) {
+            std::function<void(int)> task;
+            if (popOwn(worker, task) || steal(worker, task)) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    --queued;
+                }
+                task(worker);
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--pending == 0) all_done.notify_all();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            task_ready.wait(lock, [&] { return stopping || queued > 0; });
+            if (stopping && queued == 0) return;
+        }
+    }
 
-            auto end = std::chrono::high_resolution_clock::now();
-            std::chrono::duration<double> duration = end - start;
-            durations.push_back(duration.count());
-            if (best_fitness > best_value) best_value = best_fitness;
+public:
+    explicit ThreadPool(int n_threads) : queued(0), pending(0), next_queue(0), stopping(false) {
+        n_threads = std::max(1, n_threads);
+        for (int t = 0; t < n_threads; ++t) queues.push_back(std::make_unique<WorkerQueue>());
+        for (int t = 0; t < n_threads; ++t) workers.emplace_back(&ThreadPool::workerLoop, this, t);
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
         }
+        task_ready.notify_all();
+        for (std::thread& t : workers) t.join();
+    }
 
-        double avg = std::accumulate(durations.begin(), durations.end(), 0.0) / durations.size();
-        double sq_sum = std::inner_product(durations.begin(), durations.end(), durations.begin(), 0.0);
-        double std_dev = std::sqrt(sq_sum / durations.size() - avg * avg);
+    int size() const { return static_cast<int>(workers.size()); }
 
-        return {best_value, avg, std_dev};
+    void submit(std::function<void(int)> task) {
+        size_t target;
+        {
+            // Se cuenta antes de encolar para que `queued` nunca baje de cero
+            std::lock_guard<std::mutex> lock(mutex);
+            target = next_queue++ % queues.size();
+            ++pending;
+            ++queued;
+        }
+        {
+            WorkerQueue& q = *queues[target];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.tasks.push_back(std::move(task));
+        }
+        task_ready.notify_all();
+    }
+
+    // Espera a que terminen todas las tareas enviadas
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        all_done.wait(lock, [&] { return pending == 0; });
     }
 };
 
-int main() {
-    std::ifstream config_file("config.txt");
-    std::ofstream out("resultados.csv");
-    out << "n_items,n_nests,max_iter,best_fitness,avg_time,std_dev\n";
+// ===================== Buzones de migracion =====================
+// Cola circular sin bloqueos de un productor y un consumidor: cada par
+// (isla origen, isla destino) tiene su propio buzon. Si esta lleno, el
+// emigrante se descarta en lugar de esperar.
+class MigrantMailbox {
+private:
+    size_t stride;
+    size_t capacity;
+    int dims;
+    std::vector<uint64_t> words;
+    std::vector<long long> slot_weight; // dims por posicion
+    std::vector<long long> slot_value;
+    std::atomic<size_t> head; // siguiente posicion a escribir (productor)
+    std::atomic<size_t> tail; // siguiente posicion a leer (consumidor)
 
-    std::string line;
-    while (std::getline(config_file, line)) {
-        if (line.empty()) continue;
-        std::istringstream iss(line);
-        int n_items, n_nests, max_iter, repetitions;
-        iss >> n_items >> n_nests >> max_iter >> repetitions;
+public:
+    MigrantMailbox(size_t slots, size_t stride_words, int dimensions)
+        : stride(stride_words), capacity(slots), dims(dimensions), words(slots * stride_words, 0),
+          slot_weight(slots * dimensions, 0), slot_value(slots, 0), head(0), tail(0) {}
+
+    bool push(const uint64_t* solution, const long long* weight, long long value) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == capacity) return false;
+        size_t slot = h % capacity;
+        std::copy(solution, solution + stride, words.data() + slot * stride);
+        std::copy(weight, weight + dims, slot_weight.data() + slot * dims);
+        slot_value[slot] = value;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(uint64_t* solution, long long* weight, long long& value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+        size_t slot = t % capacity;
+        std::copy(words.data() + slot * stride, words.data() + (slot + 1) * stride, solution);
+        std::copy(slot_weight.data() + slot * dims, slot_weight.data() + (slot + 1) * dims, weight);
+        value = slot_value[slot];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+// Barrera reutilizable para sincronizar las islas en cada migracion: asi lo
+// que recibe cada isla no depende de la velocidad relativa de los hilos
+class EpochBarrier {
+private:
+    std::mutex mutex;
+    std::condition_variable cv;
+    int parties;
+    int waiting;
+    unsigned long long generation;
+
+public:
+    explicit EpochBarrier(int n) : parties(n), waiting(0), generation(0) {}
+
+    void arriveAndWait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        unsigned long long gen = generation;
+        if (++waiting == parties) {
+            waiting = 0;
+            generation++;
+            cv.notify_all();
+            return;
+        }
+        cv.wait(lock, [&] { return gen != generation; });
+    }
+};
 
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> peso_dist(1, 10);
-        std::uniform_int_distribution<> valor_dist(10, 100);
+// Equipo fijo de hilos: run() despierta a los
+// auxiliares, ejecuta job(0) en el hilo que llama y vuelve cuando todos
+// terminaron su job(t). El trabajo se fija al crear el equipo, asi cada fase
+// cuesta dos barreras y ninguna reserva de memoria. Con tamano 1 no hay hilos.
+class WorkerTeam {
+private:
+    std::function<void(int)> job;
+    EpochBarrier start_barrier;
+    EpochBarrier done_barrier;
+    std::atomic<bool> stopping;
+    std::vector<std::thread> threads;
 
-        std::vector<Item> items(n_items);
-        int total_peso = 0;
-        for (int i = 0; i < n_items; ++i) {
-            items[i].peso = peso_dist(gen);
-            items[i].valor = valor_dist(gen);
-            total_peso += items[i].peso;
+public:
+    WorkerTeam(int size, std::function<void(int)> work)
+        : job(std::move(work)), start_barrier(size), done_barrier(size), stopping(false) {
+        for (int t = 1; t < size; ++t) {
+            threads.emplace_back([this, t]() {
+                for (;;) {
+                    start_barrier.arriveAndWait();
+                    if (stopping.load()) return;
+                    job(t);
+                    done_barrier.arriveAndWait();
+                }
+            });
         }
+    }
+    ~WorkerTeam() {
+        stopping.store(true);
+        start_barrier.arriveAndWait();
+        for (std::thread& t : threads) t.join();
+    }
+    WorkerTeam(const WorkerTeam&) = delete;
+    WorkerTeam& operator=(const WorkerTeam&) = delete;
+
+    int size() const { return static_cast<int>(threads.size()) + 1; }
+
+    void run() {
+        start_barrier.arriveAndWait();
+        job(0);
+        done_barrier.arriveAndWait();
+    }
+};
+
+enum class Topology { Ring, Random };
+
+// Parametros del modo islas
+struct IslandOptions {
+    int islands = 4;            // poblaciones (y hilos) concurrentes
+    int migration_interval = 50; // iteraciones entre migraciones
+    int migrants = 2;           // mejores nidos enviados por migracion
+    Topology topology = Topology::Ring;
+};
 
-        int capacity = static_cast<int>(0.4 * total_peso);
-        double pa = 0.25;
-        double a = 1.0;
+enum class LevyMode { Dense, Sparse };
 
-        CuckooSearchKnapsack cuckoo(items, capacity, n_nests, max_iter, pa, a);
-        auto [best_fitness, avg_time, std_dev] = cuckoo.repeatedRuns(repetitions);
+// Criterio de parada combinable; cada condicion desactivada (0, u objetivo
+// negativo) se ignora y max_iter sigue siendo el limite duro
+struct StopPolicy {
+    long long target = -1;                    // fitness objetivo
+    int stagnation = 0;                       // iteraciones seguidas sin mejora
+    double deadline = 0.0;                    // segundos de pared desde el inicio
+    unsigned long long max_evaluations = 0;   // evaluaciones de fitness
 
-        out << n_items << "," << n_nests << "," << max_iter << ","
-            << best_fitness << "," << avg_time << "," << std_dev << "\n";
+    bool needsClock() const { return deadline > 0.0; }
+
+    bool shouldStop(long long best_fitness, int since_improvement, double elapsed, unsigned long long evaluations) const {
+        return (target >= 0 && best_fitness >= target) || (stagnation > 0 && since_improvement >= stagnation) ||
+               (deadline > 0.0 && elapsed >= deadline) || (max_evaluations > 0 && evaluations >= max_evaluations);
     }
+};
+
+// Mejora del mejor fitness de una ejecucion
+struct Improvement {
+    double seconds; // desde el inicio de la ejecucion
+    long long fitness;
+};
+
+// ===================== Perfilado por fases =====================
+// Tiempo por fase del bucle principal y contadores de eventos, acumulados
+// por ejecucion en su espacio de trabajo. Se compila fuera con
+// -DCSA_PERFILAR=0 (las marcas quedan vacias y sus columnas del CSV
+// tambien). En x86 el reloj es el contador de ciclos (rdtsc, unos ns por
+// lectura); en otras arquitecturas, steady_clock.
+#ifndef CSA_PERFILAR
+#define CSA_PERFILAR 1
+#endif
+
+enum Phase { PHASE_INIT, PHASE_LEVY, PHASE_EVAL, PHASE_SELECT, PHASE_REPLACE, PHASE_MIGRATE, PHASE_COUNT };
+
+inline uint64_t profileTicks() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Ticks por segundo, calibrados una vez contra steady_clock (~20 ms)
+inline double profileTicksPerSecond() {
+    static const double rate = []() {
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t c0 = profileTicks();
+        double elapsed = 0.0;
+        while (elapsed < 0.02) elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        return (profileTicks() - c0) / elapsed;
+    }();
+    return rate;
+}
+
+struct PhaseProfile {
+    uint64_t ticks[PHASE_COUNT] = {};
+    unsigned long long evaluations = 0;  // evaluaciones de fitness
+    unsigned long long accepted = 0;     // candidatos que reemplazaron a un nido
+    unsigned long long improvements = 0; // mejoras del mejor fitness
+    unsigned long long cache_hits = 0;   // candidatos cuyo fitness salio de la cache
+    unsigned long long cache_misses = 0; // candidatos evaluados y guardados en la cache
+    unsigned long long duplicates = 0;   // candidatos iguales a un nido de la poblacion
+
+    void merge(const PhaseProfile& other) {
+        for (int p = 0; p < PHASE_COUNT; ++p) ticks[p] += other.ticks[p];
+        evaluations += other.evaluations;
+        accepted += other.accepted;
+        improvements += other.improvements;
+        cache_hits += other.cache_hits;
+        cache_misses += other.cache_misses;
+        duplicates += other.duplicates;
+    }
+    double seconds(Phase p) const { return ticks[p] / profileTicksPerSecond(); }
+};
+
+// Cronometro por vueltas: mark(fase) suma a esa fase el tiempo desde la
+// marca anterior, asi cada fase cuesta una sola lectura del reloj
+class PhaseLap {
+#if CSA_PERFILAR
+private:
+    PhaseProfile& profile;
+    uint64_t last;
+
+public:
+    explicit PhaseLap(PhaseProfile& p) : profile(p), last(profileTicks()) {}
+    void mark(Phase phase) {
+        uint64_t now = profileTicks();
+        profile.ticks[phase] += now - last;
+        last = now;
+    }
+#else
+public:
+    explicit PhaseLap(PhaseProfile&) {}
+    void mark(Phase) {}
+#endif
+};
+
+#if CSA_PERFILAR
+#define CSA_CONTAR(counter) (++(counter))
+#define CSA_SUMAR(counter, n) ((counter) += (n))
+#else
+#define CSA_CONTAR(counter) ((void)0)
+#define CSA_SUMAR(counter, n) ((void)0)
+#endif
+
+// ===================== Telemetria de convergencia =====================
+// Muestras del mejor fitness que se escriben a disco por bloques en vez de
+// guardar la evolucion completa en memoria. Modo `Improvements`: una muestra
+// por mejora; modo `LogSpaced`: muestras en iteraciones espaciadas
+// logaritmicamente (~10 por decada). Siempre se anaden la iteracion 0 y la
+// de parada, asi cada curva empieza y termina donde lo hizo la ejecucion.
+enum class TelemetryMode { Off, Improvements, LogSpaced };
+
+struct TelemetrySample {
+    uint32_t config;
+    uint32_t rep;
+    uint32_t island;
+    uint32_t iteration;
+    int64_t fitness;
+    double seconds; // registro binario de 32 bytes
+};
+
+// Archivo de telemetria compartido por todos los hilos. Con extension .bin
+// escribe la cabecera "CSAT", la version y el tamano del registro (uint32
+// cada uno) seguidos de registros TelemetrySample; si no, CSV.
+class TelemetryWriter {
+private:
+    std::mutex mutex;
+    FILE* file;
+    bool binary;
+
+public:
+    explicit TelemetryWriter(const std::string& path)
+        : file(std::fopen(path.c_str(), "wb")),
+          binary(path.size() >= 4 && path.compare(path.size() - 4, 4, ".bin") == 0) {
+        if (!file) return;
+        if (binary) {
+            const uint32_t header[3] = {0x54415343u /* "CSAT" */, 2u, static_cast<uint32_t>(sizeof(TelemetrySample))};
+            std::fwrite(header, sizeof(uint32_t), 3, file);
+        } else {
+            std::fputs("config,rep,island,iteration,seconds,fitness\n", file);
+        }
+    }
+    ~TelemetryWriter() {
+        if (file) std::fclose(file);
+    }
+    TelemetryWriter(const TelemetryWriter&) = delete;
+    TelemetryWriter& operator=(const TelemetryWriter&) = delete;
+
+    bool ok() const { return file != nullptr; }
+
+    void write(const TelemetrySample* samples, size_t count) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!file) return;
+        if (binary) {
+            std::fwrite(samples, sizeof(TelemetrySample), count, file);
+            return;
+        }
+        char line[128];
+        for (size_t s = 0; s < count; ++s) {
+            const TelemetrySample& t = samples[s];
+            int len = std::snprintf(line, sizeof(line), "%u,%u,%u,%u,%.9g,%lld\n", t.config, t.rep, t.island,
+                                    t.iteration, t.seconds, static_cast<long long>(t.fitness));
+            std::fwrite(line, 1, static_cast<size_t>(len), file);
+        }
+    }
+};
+
+// Bufer de telemetria de un hilo: tamano fijo reservado al conectarlo, se
+// vacia en el escritor al llenarse y al terminar cada ejecucion
+class TelemetryBuffer {
+private:
+    static const size_t CAPACITY = 4096;
+    TelemetryWriter* writer = nullptr;
+    TelemetryMode mode = TelemetryMode::Off;
+    std::vector<TelemetrySample> samples;
+    size_t used = 0;
+    uint32_t config = 0, rep = 0, island = 0;
+    int next_log = 0;       // siguiente iteracion a muestrear en modo log
+    int last_iteration = -1; // ultima iteracion registrada
+
+public:
+    void attach(TelemetryWriter* w, TelemetryMode m) {
+        writer = (m == TelemetryMode::Off) ? nullptr : w;
+        mode = m;
+        samples.resize(writer ? CAPACITY : 0);
+        used = 0;
+    }
+
+    bool enabled() const { return writer != nullptr; }
+
+    void begin(uint32_t config_id, uint32_t rep_id, uint32_t island_id) {
+        config = config_id;
+        rep = rep_id;
+        island = island_id;
+        next_log = 0;
+        last_iteration = -1;
+    }
+
+    // Se llama tras cada iteracion (y con la iteracion 0 tras la poblacion inicial)
+    template<class TimePoint>
+    void step(int iteration, long long fitness, bool improved, TimePoint start) {
+        if (!writer) return;
+        bool wanted = (iteration == 0) || (mode == TelemetryMode::Improvements ? improved : iteration >= next_log);
+        if (wanted) record(iteration, fitness, start);
+    }
+
+    // Cierra la ejecucion: registra la iteracion de parada y vacia el bufer
+    template<class TimePoint>
+    void end(int iteration, long long fitness, TimePoint start) {
+        if (!writer) return;
+        if (iteration != last_iteration) record(iteration, fitness, start);
+        flush();
+    }
+
+    void flush() {
+        if (writer && used > 0) writer->write(samples.data(), used);
+        used = 0;
+    }
+
+private:
+    template<class TimePoint>
+    void record(int iteration, long long fitness, TimePoint start) {
+        double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        samples[used++] = {config, rep, island, static_cast<uint32_t>(iteration), fitness, seconds};
+        last_iteration = iteration;
+        if (mode == TelemetryMode::LogSpaced) next_log = iteration + 1 + iteration / 4;
+        if (used == samples.size()) flush();
+    }
+};
+
+// Estado propio de cada hilo del modo por lotes: su kernel de Levy, su perfil
+// y las reservas de memoria que hizo en la ejecucion en curso
+struct BatchLane {
+    LevyKernel levy;
+    SparseLevySampler sparse_levy;
+    PhaseProfile profile;
+    unsigned long long allocations = 0;
+
+    BatchLane(double alfa, double beta) : levy(beta), sparse_levy(alfa, beta) {}
+};
+
+// Estado mutable de una ejecucion. Cada hilo tiene el suyo: arena de
+// poblacion, generadores y kernels de Levy. Los generadores se reinician
+// al empezar cada repeticion con el flujo (semilla, linea, repeticion).
+struct SearchWorkspace {
+    Philox4x32 gen;
+    Xoshiro256ss bits; // bits de soluciones aleatorias, 64 por llamada
+    LevyKernel levy;
+    SparseLevySampler sparse_levy;
+    PopulationArena arena;
+    std::vector<Improvement> trace; // mejoras de la ejecucion en curso (reservado de antemano)
+    TelemetryBuffer telemetry;
+    PhaseProfile profile; // fases de la ejecucion en curso
+    std::vector<std::unique_ptr<BatchLane>> lanes; // modo por lotes: uno por hilo del equipo
+    // Modo por lotes: equipo de hilos de este espacio de trabajo, creado en la
+    // primera repeticion y reutilizado por las demas; su trabajo lee de aqui la
+    // repeticion y la generacion en curso
+    std::unique_ptr<WorkerTeam> team;
+    uint32_t team_rep = 0;
+    int team_generation = 0;
+    FitnessCache memo; // fitness por hash Zobrist, compartida por las repeticiones de este hilo
+
+    SearchWorkspace(double alfa, double beta) : levy(beta), sparse_levy(alfa, beta) {}
+
+    void reseed(uint64_t key, uint32_t stream, uint32_t rep) {
+        gen = Philox4x32(key, stream, rep);
+        bits = Xoshiro256ss(gen);
+    }
+};
+
+// Objetivo del 1% para un optimo (o una cota inferior de el): fitness >= ceil(0.99 * optimo)
+inline long long withinOnePercent(long long optimum) {
+    return static_cast<long long>(std::ceil(0.99 * optimum));
+}
+
+// Resultado de una ejecucion individual
+struct RunResult {
+    long long best_fitness;
+    double seconds;
+    unsigned long long hot_loop_allocations;
+    double time_to_best;             // segundos hasta la ultima mejora
+    double time_to_feasible = -1.0;  // segundos hasta el primer fitness > 0 (-1 si nunca)
+    // Cola del historial del mejor fitness: solo las mejoras desde
+    // withinOnePercent(best_fitness). El optimo es al menos best_fitness, asi
+    // que el objetivo del 1% nunca queda por debajo y timeToReach da lo mismo
+    // que con el historial completo, que no se copia.
+    std::vector<Improvement> trace;
+    int stop_iteration = 0;         // iteraciones ejecutadas hasta la parada
+    PhaseProfile profile;           // en modo islas, la suma de todas las islas
+
+    // Se queda con el primer instante factible y la cola de `full`, ordenado
+    // por tiempo y creciente en fitness
+    void keepTrace(const std::vector<Improvement>& full) {
+        const long long cutoff = withinOnePercent(best_fitness);
+        trace.clear();
+        for (const Improvement& imp : full) {
+            if (time_to_feasible < 0 && imp.fitness > 0) time_to_feasible = imp.seconds;
+            if (imp.fitness >= cutoff) trace.push_back(imp);
+        }
+    }
+};
+
+// Primer instante de `trace` en que el mejor fitness llega a `target` (-1 si nunca)
+inline double timeToReach(const std::vector<Improvement>& trace, long long target) {
+    for (const Improvement& imp : trace) {
+        if (imp.fitness >= target) return imp.seconds;
+    }
+    return -1.0;
+}
+
+// Estadisticas en linea de memoria acotada: media y varianza de Welford,
+// minimo, maximo y percentiles de un histograma log-lineal al estilo HDR.
+// Cada valor se cuenta en unidades de `resolution` (1 ns para tiempos);
+// por debajo de 2^8 unidades los cubos son exactos y por encima cada
+// potencia de dos se divide en 128 cubos, asi el error relativo de un
+// percentil es menor que 1/128. El histograma crece solo hasta el mayor
+// cubo usado (unos 3500 cubos para un minuto en ns).
+class RunningStats {
+private:
+    static const int SUB_BITS = 8;
+    static const uint64_t HALF = 1ULL << (SUB_BITS - 1);
+    double resolution;
+    unsigned long long n = 0;
+    double mean_ = 0.0, m2 = 0.0;
+    double min_ = 0.0, max_ = 0.0;
+    std::vector<unsigned long long> buckets;
+
+    static size_t bucketOf(uint64_t ticks) {
+        if (ticks < (1ULL << SUB_BITS)) return static_cast<size_t>(ticks);
+        int msb = 63 - leadingZeros(ticks);
+        int shift = msb - (SUB_BITS - 1);
+        return static_cast<size_t>(shift * HALF + (ticks >> shift));
+    }
+
+    // Punto medio del cubo, en unidades
+    static double bucketValue(size_t idx) {
+        if (idx < (1ULL << SUB_BITS)) return static_cast<double>(idx);
+        uint64_t shift = idx / HALF - 1;
+        uint64_t sub = idx - shift * HALF;
+        return std::ldexp(static_cast<double>(sub), static_cast<int>(shift)) + (std::ldexp(1.0, static_cast<int>(shift)) - 1) / 2;
+    }
+
+    // Ceros a la izquierda de w (w != 0)
+    static int leadingZeros(uint64_t w) {
+#if defined(_MSC_VER)
+        unsigned long idx;
+        _BitScanReverse64(&idx, w);
+        return 63 - static_cast<int>(idx);
+#else
+        return __builtin_clzll(w);
+#endif
+    }
+
+public:
+    explicit RunningStats(double resolution = 1.0) : resolution(resolution) {}
+
+    void add(double x) {
+        n++;
+        double delta = x - mean_;
+        mean_ += delta / n;
+        m2 += delta * (x - mean_);
+        if (n == 1 || x < min_) min_ = x;
+        if (n == 1 || x > max_) max_ = x;
+        double scaled = std::max(0.0, x / resolution);
+        uint64_t ticks = scaled >= 9.2e18 ? (1ULL << 63) : static_cast<uint64_t>(std::llround(scaled));
+        size_t idx = bucketOf(ticks);
+        if (idx >= buckets.size()) buckets.resize(idx + 1, 0);
+        buckets[idx]++;
+    }
+
+    unsigned long long count() const { return n; }
+    double mean() const { return mean_; }
+    // Varianza poblacional (divide por n, como el calculo original)
+    double variance() const { return n ? m2 / n : 0.0; }
+    double stddev() const { return std::sqrt(variance()); }
+    double min() const { return min_; }
+    double max() const { return max_; }
+
+    // Percentil q en [0, 1] (menor valor con al menos q * n muestras <= el)
+    double percentile(double q) const {
+        if (n == 0) return 0.0;
+        unsigned long long rank = static_cast<unsigned long long>(std::ceil(q * n));
+        rank = std::max(1ULL, std::min(rank, n));
+        unsigned long long seen = 0;
+        for (size_t idx = 0; idx < buckets.size(); ++idx) {
+            seen += buckets[idx];
+            if (seen >= rank) {
+                double v = bucketValue(idx) * resolution;
+                return std::min(max_, std::max(min_, v));
+            }
+        }
+        return max_;
+    }
+};
+
+// Resumen de las repeticiones de una configuracion en memoria constante:
+// cada resultado se acumula al llegar y se descarta. El tiempo hasta el 1%
+// necesita el optimo; si se espera (expectOptimum) y aun no se conoce, se
+// guardan solo las colas de los historiales (RunResult::trace) hasta que
+// llegue. Cada cola tiene a lo sumo min(iteraciones, 1% del mejor fitness) + 1
+// mejoras, y como los optimos se envian al pool antes que las repeticiones,
+// rara vez espera mas de una repeticion por hilo.
+class RunsSummary {
+public:
+    RunningStats time{1e-9};             // segundos por repeticion
+    RunningStats time_to_best{1e-9};
+    RunningStats time_to_feasible{1e-9}; // solo repeticiones con fitness > 0
+    RunningStats time_to_target{1e-9};   // solo las que quedaron a 1% del optimo
+    RunningStats stop_iteration{1.0};
+    long long best_value = 0;
+    unsigned long long hot_loop_allocations = 0; // reservas dentro del bucle principal
+    PhaseProfile profile;                        // suma de todas las repeticiones
+
+    void expectOptimum() { waiting = true; }
+
+    // `optimum` < 0 si no se pudo calcular
+    void setOptimum(long long optimum) {
+        target = (optimum < 0) ? -1 : withinOnePercent(optimum);
+        waiting = false;
+        for (const std::vector<Improvement>& trace : pending) addTarget(trace);
+        pending.clear();
+        pending.shrink_to_fit();
+    }
+
+    void add(RunResult&& r) {
+        time.add(r.seconds);
+        time_to_best.add(r.time_to_best);
+        stop_iteration.add(r.stop_iteration);
+        if (r.best_fitness > best_value) best_value = r.best_fitness;
+        hot_loop_allocations += r.hot_loop_allocations;
+        profile.merge(r.profile);
+        if (r.time_to_feasible >= 0) time_to_feasible.add(r.time_to_feasible);
+        if (waiting) pending.push_back(std::move(r.trace));
+        else addTarget(r.trace);
+    }
+
+private:
+    long long target = -1;
+    bool waiting = false;
+    std::vector<std::vector<Improvement>> pending;
+
+    void addTarget(const std::vector<Improvement>& trace) {
+        double t = (target < 0) ? -1.0 : timeToReach(trace, target);
+        if (t >= 0) time_to_target.add(t);
+    }
+};
+
+// Unos minimos de una palabra para sumarla con mascaras en vez de bit a bit
+const int MASKED_MIN_BITS = 8;
+// Fraccion maxima de items cambiados para evaluar un hijo desde los totales
+// del padre: por encima la reduccion completa es mas barata (en --bench el
+// cruce esta entre 20% y 30% con D = 1..4; Levy denso cambia ~47%)
+const double DELTA_MAX_FLIPPED = 0.25;
+// Modo por lotes: palabras por bloque de items (32 palabras = 2048 items,
+// 8 KB por fila de valores o pesos) y trabajo minimo por generacion
+// (nidos x items) para repartirla entre varios hilos
+const size_t BATCH_BLOCK_WORDS = 32;
+const double BATCH_PARALLEL_MIN_ITEMS = 1 << 15;
+
+class CuckooSearchKnapsack {
+private:
+    std::shared_ptr<const ItemStore> store; // compartido, nunca se copia
+    size_t n_items;
+    size_t n_words;
+    int dims;
+    int n_nests;
+    int max_iter;
+    double pa;
+    double alfa;
+    double beta;
+    LevyMode levy_mode;
+    BernoulliWords init_bits; // densidad de las soluciones aleatorias
+    bool repair_enabled;      // reparar candidatos y nidos regenerados
+    bool greedy_init;         // sembrar la poblacion inicial con la solucion voraz
+    bool batch_enabled;       // generaciones por lotes (un candidato por nido)
+    int batch_threads;        // hilos por ejecucion en el modo por lotes
+    int memo_bits;            // cache de fitness de 2^memo_bits entradas por hilo (0: sin cache)
+    // Hash Zobrist: una clave aleatoria por item; el hash de una solucion es
+    // la base XOR las claves de sus items, asi invertir un bit es un XOR
+    std::vector<uint64_t> zobrist_keys;
+    uint64_t zobrist_base;
+    StopPolicy stop_policy;
+    TelemetryWriter* telemetry_writer; // compartido, propiedad del llamador
+    TelemetryMode telemetry_mode;
+    uint64_t seed;
+    uint32_t stream; // identifica la linea de config dentro de la semilla
+    // Un espacio de trabajo por hilo, reutilizado entre repeticiones
+    std::vector<std::unique_ptr<SearchWorkspace>> workspaces;
+    // Items por ratio valor/peso decreciente y, para cada posicion y
+    // restriccion, el menor peso desde ahi hasta el final (corta la fase de
+    // anadir de la reparacion). Con D > 1 el peso de un item es la suma de
+    // sus pesos relativos a cada capacidad.
+    std::vector<int> ratio_order;
+    std::vector<int> min_peso_from; // (n_items + 1) * dims
+
+public:
+    CuckooSearchKnapsack(std::shared_ptr<const ItemStore> items, int nests, int iterations, double prob_abandon, double a)
+        : store(std::move(items)), n_items(store->size()), n_words(store->wordCount()), dims(store->dimensions()),
+          n_nests(nests), max_iter(iterations), pa(prob_abandon), alfa(a),
+          beta(1.5), levy_mode(LevyMode::Dense), init_bits(0.5), repair_enabled(false), greedy_init(false), batch_enabled(false), batch_threads(1), memo_bits(0), zobrist_base(0), telemetry_writer(nullptr), telemetry_mode(TelemetryMode::Off), seed((static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}()), stream(0) {
+        const ItemStore& s = *store;
+        ratio_order.resize(n_items);
+        std::iota(ratio_order.begin(), ratio_order.end(), 0);
+        if (dims == 1) {
+            std::stable_sort(ratio_order.begin(), ratio_order.end(), [&](int a, int b) {
+                if (s.weight(a) == 0 || s.weight(b) == 0) return s.weight(a) == 0 && s.weight(b) != 0;
+                return static_cast<long long>(s.value(a)) * s.weight(b) > static_cast<long long>(s.value(b)) * s.weight(a);
+            });
+        } else {
+            std::vector<double> cost(n_items, 0.0);
+            for (size_t i = 0; i < n_items; ++i) {
+                for (int d = 0; d < dims; ++d) cost[i] += static_cast<double>(s.weight(i, d)) / std::max(1LL, s.capacity(d));
+            }
+            std::stable_sort(ratio_order.begin(), ratio_order.end(), [&](int a, int b) {
+                if (cost[a] == 0.0 || cost[b] == 0.0) return cost[a] == 0.0 && cost[b] != 0.0;
+                return s.value(a) * cost[b] > s.value(b) * cost[a];
+            });
+        }
+        min_peso_from.assign((n_items + 1) * dims, std::numeric_limits<int>::max());
+        for (int t = static_cast<int>(n_items) - 1; t >= 0; --t) {
+            for (int d = 0; d < dims; ++d) {
+                min_peso_from[t * dims + d] = std::min(min_peso_from[(t + 1) * dims + d], s.weight(ratio_order[t], d));
+            }
+        }
+    }
+
+    // Crea de antemano los espacios de trabajo [0, count): despues pueden
+    // usarse desde varios hilos sin tocar el vector
+    void prepareWorkspaces(int count) {
+        if (count > 0) workspace(count - 1);
+    }
+
+    // La repeticion r usa siempre el flujo (semilla, stream, r), la ejecute el hilo que la ejecute
+    void setSeed(uint64_t s, uint32_t stream_id) {
+        seed = s;
+        stream = stream_id;
+    }
+    const std::shared_ptr<const ItemStore>& getStore() const { return store; }
+    long long getCapacity() const { return store->capacity(); }
+    // Nidos regenerados por iteracion
+    int replacementsPerIteration() const { return static_cast<int>(pa * n_nests); }
+
+    // Espacio de trabajo del hilo `worker`
+    SearchWorkspace& workspace(int worker) {
+        while (static_cast<int>(workspaces.size()) <= worker) {
+            workspaces.push_back(std::make_unique<SearchWorkspace>(alfa, beta));
+            workspaces.back()->telemetry.attach(telemetry_writer, telemetry_mode);
+            workspaces.back()->memo.reset(memo_bits);
+        }
+        return *workspaces[worker];
+    }
+
+    // Totales como reduccion enmascarada sobre las palabras empaquetadas,
+    // el valor y las D restricciones en la misma pasada. Las palabras con
+    // muchos unos se suman sin saltos con mascaras AVX2 si el almacen lo
+    // permite; si no, se recorren solo los bits del lado mas escaso (con mas
+    // de 32 unos se parte del total de la palabra y se restan los ceros).
+    // FIXED_D fija D en compilacion (0: en ejecucion) y entonces los totales
+    // viven en registros. Suma las palabras [w_begin, w_end) a los totales.
+    template <int FIXED_D>
+    void accumulateWords(const uint64_t* solution, size_t w_begin, size_t w_end, long long* out_weight,
+                         long long& out_value) const {
+        const ItemStore& s = *store;
+        const int D = FIXED_D ? FIXED_D : dims;
+        const int* values = s.values();
+        const int* const* weights = s.weightRows();
+        const bool masked = s.maskedSums();
+        long long local[FIXED_D ? FIXED_D : 1];
+        long long* total_weight = FIXED_D ? local : out_weight;
+        if (FIXED_D) std::copy(out_weight, out_weight + D, total_weight);
+        long long total_value = out_value;
+        long long word_sums[(FIXED_D ? FIXED_D : MASKED_MAX_DIMS) + 1]; // valor y pesos de una palabra
+        for (size_t w = w_begin; w < w_end; ++w) {
+            uint64_t bits = solution[w];
+            const size_t base = w << 6;
+            size_t valid = std::min<size_t>(64, n_items - base);
+            const int ones = popcount64(bits);
+            if (masked && ones >= MASKED_MIN_BITS) {
+                std::fill(word_sums, word_sums + D + 1, 0LL);
+                s.addMaskedWord(w, bits, word_sums);
+                total_value += word_sums[0];
+                for (int d = 0; d < D; ++d) total_weight[d] += word_sums[1 + d];
+            } else if (valid == 64 && ones > 32) {
+                const long long* word_weights = s.wordWeights(w);
+                for (int d = 0; d < D; ++d) total_weight[d] += word_weights[d];
+                total_value += s.wordValue(w);
+                bits = ~bits;
+                while (bits) {
+                    const size_t i = base + lowestBit(bits);
+                    for (int d = 0; d < D; ++d) total_weight[d] -= weights[d][i];
+                    total_value -= values[i];
+                    bits &= bits - 1;
+                }
+            } else {
+                while (bits) {
+                    const size_t i = base + lowestBit(bits);
+                    for (int d = 0; d < D; ++d) total_weight[d] += weights[d][i];
+                    total_value += values[i];
+                    bits &= bits - 1;
+                }
+            }
+        }
+        if (FIXED_D) std::copy(total_weight, total_weight + D, out_weight);
+        out_value = total_value;
+    }
+
+    void accumulateRange(const uint64_t* solution, size_t w_begin, size_t w_end, long long* total_weight,
+                         long long& total_value) const {
+        if (dims == 1) accumulateWords<1>(solution, w_begin, w_end, total_weight, total_value);
+        else accumulateWords<0>(solution, w_begin, w_end, total_weight, total_value);
+    }
+
+    void accumulate(const uint64_t* solution, long long* total_weight, long long& total_value) const {
+        std::fill(total_weight, total_weight + dims, 0LL);
+        total_value = 0;
+        accumulateRange(solution, 0, n_words, total_weight, total_value);
+    }
+
+    // Totales de los candidatos [begin, end) de la arena como un nucleo
+    // poblacion x items: los items se recorren por bloques de
+    // BATCH_BLOCK_WORDS palabras y cada bloque de valores y pesos se suma a
+    // todos los candidatos mientras sigue en cache
+    void evaluateCandidates(PopulationArena& arena, int begin, int end) const {
+        for (int c = begin; c < end; ++c) {
+            std::fill(arena.candidateWeight(c), arena.candidateWeight(c) + dims, 0LL);
+            arena.candidateValue(c) = 0;
+        }
+        for (size_t w0 = 0; w0 < n_words; w0 += BATCH_BLOCK_WORDS) {
+            const size_t w1 = std::min(n_words, w0 + BATCH_BLOCK_WORDS);
+            for (int c = begin; c < end; ++c) {
+                accumulateRange(arena.candidate(c), w0, w1, arena.candidateWeight(c), arena.candidateValue(c));
+            }
+        }
+    }
+
+    // Evaluacion incremental: parte de los totales del padre y aplica solo
+    // los bits distintos (XOR por palabra), O(bits cambiados)
+    template <int FIXED_D>
+    void accumulateDeltaWords(const uint64_t* parent, const long long* parent_weight, long long parent_value,
+                              const uint64_t* child, long long* out_weight, long long& out_value) const {
+        const ItemStore& s = *store;
+        const int D = FIXED_D ? FIXED_D : dims;
+        const int* values = s.values();
+        const int* const* weights = s.weightRows();
+        long long local[FIXED_D ? FIXED_D : 1];
+        long long* total_weight = FIXED_D ? local : out_weight;
+        std::copy(parent_weight, parent_weight + D, total_weight);
+        long long total_value = parent_value;
+        for (size_t w = 0; w < n_words; ++w) {
+            uint64_t now = child[w];
+            uint64_t diff = now ^ parent[w];
+            const size_t base = w << 6;
+            while (diff) {
+                int b = lowestBit(diff);
+                const size_t i = base + b;
+                long long sign = ((now >> b) & 1ULL) ? 1 : -1;
+                for (int d = 0; d < D; ++d) total_weight[d] += sign * weights[d][i];
+                total_value += sign * values[i];
+                diff &= diff - 1;
+            }
+        }
+        if (FIXED_D) std::copy(total_weight, total_weight + D, out_weight);
+        out_value = total_value;
+    }
+
+    void accumulateDelta(const uint64_t* parent, const long long* parent_weight, long long parent_value,
+                         const uint64_t* child, long long* total_weight, long long& total_value) const {
+        if (dims == 1) accumulateDeltaWords<1>(parent, parent_weight, parent_value, child, total_weight, total_value);
+        else accumulateDeltaWords<0>(parent, parent_weight, parent_value, child, total_weight, total_value);
+    }
+
+    // Totales de un hijo: desde los del padre si cambio a lo sumo
+    // DELTA_MAX_FLIPPED de los items, y si no con la reduccion completa
+    void evaluateChild(const uint64_t* parent, const long long* parent_weight, long long parent_value,
+                       const uint64_t* child, long long* total_weight, long long& total_value) const {
+        size_t flipped = 0;
+        for (size_t w = 0; w < n_words; ++w) flipped += popcount64(parent[w] ^ child[w]);
+        if (flipped <= DELTA_MAX_FLIPPED * n_items) accumulateDelta(parent, parent_weight, parent_value, child, total_weight, total_value);
+        else accumulate(child, total_weight, total_value);
+    }
+
+    long long fitnessFromTotals(const long long* total_weight, long long total_value) const {
+        return store->fits(total_weight) ? total_value : 0;
+    }
+
+    // La cache de fitness solo se usa en el bucle secuencial y sin reparacion
+    // (un acierto no diria en que solucion queda el candidato reparado)
+    bool memoActive() const { return memo_bits > 0 && !repair_enabled && !batch_enabled; }
+
+    // Hash Zobrist completo de una solucion, O(items elegidos)
+    uint64_t zobristHash(const uint64_t* solution) const {
+        uint64_t h = zobrist_base;
+        for (size_t w = 0; w < n_words; ++w) {
+            const uint64_t* keys = zobrist_keys.data() + (w << 6);
+            for (uint64_t bits = solution[w]; bits; bits &= bits - 1) h ^= keys[lowestBit(bits)];
+        }
+        return h;
+    }
+
+    // Hash del hijo a partir del hash del padre: solo los bits que cambian
+    uint64_t zobristDelta(uint64_t parent_hash, const uint64_t* parent, const uint64_t* child) const {
+        uint64_t h = parent_hash;
+        for (size_t w = 0; w < n_words; ++w) {
+            const uint64_t* keys = zobrist_keys.data() + (w << 6);
+            for (uint64_t diff = parent[w] ^ child[w]; diff; diff &= diff - 1) h ^= keys[lowestBit(diff)];
+        }
+        return h;
+    }
+
+    // Rellena una fila con una solucion aleatoria, 64 items por palabra
+    void fillRandomSolution(SearchWorkspace& ws, uint64_t* nest) {
+        for (size_t w = 0; w < n_words; ++w) nest[w] = init_bits(ws.bits);
+        // Los bits sobrantes de la ultima palabra quedan a cero
+        if (n_items & 63) nest[n_words - 1] &= (1ULL << (n_items & 63)) - 1;
+    }
+
+    void setLevyMode(LevyMode mode) { levy_mode = mode; }
+    void setRepair(bool enabled) { repair_enabled = enabled; }
+    void setGreedyInit(bool enabled) { greedy_init = enabled; }
+    void setBatch(bool enabled, int threads) {
+        batch_enabled = enabled;
+        batch_threads = std::max(1, threads);
+    }
+    // Hilos de una ejecucion por lotes: solo si la generacion es grande
+    int batchTeamSize() const {
+        bool large = static_cast<double>(n_nests) * n_items >= BATCH_PARALLEL_MIN_ITEMS;
+        return (batch_enabled && large) ? batch_threads : 1;
+    }
+    // Cache de fitness de 2^bits entradas por espacio de trabajo (0: sin
+    // cache). Las claves Zobrist no dependen de la semilla: el hash no cambia
+    // el resultado de la busqueda.
+    void setMemo(int bits) {
+        memo_bits = std::max(0, std::min(bits, FITNESS_CACHE_MAX_BITS));
+        if (memo_bits > 0 && zobrist_keys.empty()) {
+            Philox4x32 gen(0, 0, STREAM_ZOBRIST);
+            auto next64 = [&gen]() { return (static_cast<uint64_t>(gen()) << 32) | gen(); };
+            zobrist_keys.resize(n_words * 64);
+            for (uint64_t& key : zobrist_keys) key = next64();
+            zobrist_base = next64();
+        }
+        for (auto& ws : workspaces) ws->memo.reset(memo_bits);
+    }
+    void setStopPolicy(const StopPolicy& policy) { stop_policy = policy; }
+    // Conecta la telemetria (antes de crear los espacios de trabajo)
+    void setTelemetry(TelemetryWriter* writer, TelemetryMode mode) {
+        telemetry_writer = writer;
+        telemetry_mode = mode;
+        for (auto& ws : workspaces) ws->telemetry.attach(writer, mode);
+    }
+    const StopPolicy& getStopPolicy() const { return stop_policy; }
+
+    // Evaluaciones de fitness: la poblacion inicial y, por iteracion, el
+    // candidato (uno por nido en el modo por lotes) y los nidos regenerados
+    unsigned long long evaluationsAfter(int iterations) const {
+        int candidates = batch_enabled ? n_nests : 1;
+        return n_nests + static_cast<unsigned long long>(iterations) * (candidates + replacementsPerIteration());
+    }
+    // Probabilidad de que cada item entre en una solucion aleatoria
+    void setInitialDensity(double p) { init_bits.setProbability(p); }
+
+    // Nueva solucion mediante Levy flight (beta = 1.5), un candidato por pasada.
+    // En modo disperso se muestrea la misma distribucion por saltos geometricos.
+    void levyFlightInto(SearchWorkspace& ws, const uint64_t* current_solution, uint64_t* new_solution) {
+        if (levy_mode == LevyMode::Sparse) ws.sparse_levy.step(current_solution, new_solution, n_items, ws.gen);
+        else ws.levy.step(current_solution, new_solution, n_items, alfa, ws.gen);
+    }
+
+    // Reparacion voraz por ratio valor/peso: si la solucion excede alguna
+    // capacidad se quitan sus items de peor ratio hasta que quepa, y despues
+    // se anaden los de mejor ratio que aun quepan en todas las restricciones.
+    // Los totales se actualizan item a item.
+    void repair(uint64_t* solution, long long* total_weight, long long& total_value) const {
+        const ItemStore& s = *store;
+        const int n = static_cast<int>(ratio_order.size());
+        for (int t = n - 1; t >= 0 && !s.fits(total_weight); --t) {
+            int i = ratio_order[t];
+            uint64_t bit = 1ULL << (i & 63);
+            if (solution[i >> 6] & bit) {
+                solution[i >> 6] &= ~bit;
+                for (int d = 0; d < dims; ++d) total_weight[d] -= s.weight(i, d);
+                total_value -= s.value(i);
+            }
+        }
+        for (int t = 0; t < n && s.fitsWith(total_weight, &min_peso_from[static_cast<size_t>(t) * dims]); ++t) {
+            int i = ratio_order[t];
+            uint64_t bit = 1ULL << (i & 63);
+            if (!(solution[i >> 6] & bit) && s.fitsItem(total_weight, i)) {
+                solution[i >> 6] |= bit;
+                for (int d = 0; d < dims; ++d) total_weight[d] += s.weight(i, d);
+                total_value += s.value(i);
+            }
+        }
+    }
+
+    // Regenera el nido i en su propia fila y actualiza sus totales
+    // (el llamador actualiza el ranking)
+    void regenerateNest(SearchWorkspace& ws, int i) {
+        PopulationArena& arena = ws.arena;
+        fillRandomSolution(ws, arena.nest(i));
+        accumulate(arena.nest(i), arena.weight(i), arena.value(i));
+        CSA_CONTAR(ws.profile.evaluations);
+        if (repair_enabled) repair(arena.nest(i), arena.weight(i), arena.value(i));
+        arena.fitness_values[i] = fitnessFromTotals(arena.weight(i), arena.value(i));
+        if (memoActive()) {
+            // Los totales del nido hacen falta para evaluar a sus hijos, asi
+            // que se evalua igual; el hash sirve para los candidatos
+            arena.hash(i) = zobristHash(arena.nest(i));
+            ws.memo.insert(arena.hash(i), arena.fitness_values[i]);
+        }
+    }
+
+    // Poblacion inicial aleatoria (con inicio voraz, el nido 0 es la solucion
+    // voraz por ratio); devuelve el mejor fitness inicial
+    long long initPopulation(SearchWorkspace& ws, int candidates = 1) {
+        PopulationArena& arena = ws.arena;
+        arena.reset(n_nests, n_items, dims, candidates);
+        for (int i = 0; i < n_nests; ++i) {
+            regenerateNest(ws, i);
+        }
+        if (greedy_init && n_nests > 0) {
+            std::fill(arena.nest(0), arena.nest(0) + arena.wordsPerRow(), 0ULL);
+            std::fill(arena.weight(0), arena.weight(0) + dims, 0LL);
+            arena.value(0) = 0;
+            repair(arena.nest(0), arena.weight(0), arena.value(0));
+            arena.fitness_values[0] = fitnessFromTotals(arena.weight(0), arena.value(0));
+            if (memoActive()) arena.hash(0) = zobristHash(arena.nest(0));
+        }
+        arena.ranking.build(arena.fitness_values);
+        int best_idx = arena.ranking.best();
+        arena.saveBest(best_idx);
+        return arena.fitness_values[best_idx];
+    }
+
+    // Una iteracion de Cuckoo Search; actualiza best_fitness y devuelve true si hay mejora
+    bool cuckooIteration(SearchWorkspace& ws, long long& best_fitness) {
+        Philox4x32& gen = ws.gen;
+        PopulationArena& arena = ws.arena;
+        std::vector<long long>& fitness_values = arena.fitness_values;
+        NestRanking& ranking = arena.ranking;
+        PhaseLap lap(ws.profile);
+
+        std::uniform_int_distribution<> nest_dis(0, n_nests - 1);
+        int i = nest_dis(gen);
+        // El candidato se escribe en la fila libre de la arena
+        levyFlightInto(ws, arena.nest(i), arena.candidate());
+        lap.mark(PHASE_LEVY);
+        long long new_fitness;
+        bool totals_ready = true;
+        if (memoActive()) {
+            // Con cache: hash incremental desde el padre; si la solucion ya se
+            // evaluo, sus totales solo se calculan si el candidato se acepta
+            uint64_t h = zobristDelta(arena.hash(i), arena.nest(i), arena.candidate());
+            arena.candidateHash() = h;
+            for (int n = 0; n < n_nests; ++n) {
+                if (arena.hash(n) == h) {
+                    CSA_CONTAR(ws.profile.duplicates);
+                    break;
+                }
+            }
+            totals_ready = !ws.memo.find(h, new_fitness);
+            if (totals_ready) {
+                evaluateChild(arena.nest(i), arena.weight(i), arena.value(i), arena.candidate(),
+                              arena.candidateWeight(), arena.candidateValue());
+                new_fitness = fitnessFromTotals(arena.candidateWeight(), arena.candidateValue());
+                ws.memo.insert(h, new_fitness);
+                CSA_CONTAR(ws.profile.cache_misses);
+            } else {
+                CSA_CONTAR(ws.profile.cache_hits);
+            }
+        } else {
+            evaluateChild(arena.nest(i), arena.weight(i), arena.value(i), arena.candidate(),
+                          arena.candidateWeight(), arena.candidateValue());
+            if (repair_enabled) repair(arena.candidate(), arena.candidateWeight(), arena.candidateValue());
+            new_fitness = fitnessFromTotals(arena.candidateWeight(), arena.candidateValue());
+        }
+        CSA_CONTAR(ws.profile.evaluations);
+        lap.mark(PHASE_EVAL);
+        int j;
+        do {
+            j = nest_dis(gen);
+        } while (j == i);
+
+        if (new_fitness > fitness_values[j]) {
+            if (!totals_ready) {
+                evaluateChild(arena.nest(i), arena.weight(i), arena.value(i), arena.candidate(),
+                              arena.candidateWeight(), arena.candidateValue());
+            }
+            arena.acceptCandidate(j);
+            fitness_values[j] = new_fitness;
+            ranking.update(j);
+            CSA_CONTAR(ws.profile.accepted);
+        }
+
+        bool improved = trackBest(ws, best_fitness);
+        lap.mark(PHASE_SELECT);
+
+        replaceWorst(ws);
+        lap.mark(PHASE_REPLACE);
+        return improved;
+    }
+
+    // Guarda el mejor nido si supera a best_fitness; devuelve true si hay mejora
+    bool trackBest(SearchWorkspace& ws, long long& best_fitness) {
+        PopulationArena& arena = ws.arena;
+        int new_best_idx = arena.ranking.best();
+        long long new_best_fitness = arena.fitness_values[new_best_idx];
+        if (new_best_fitness <= best_fitness) return false;
+        best_fitness = new_best_fitness;
+        arena.saveBest(new_best_idx);
+        CSA_CONTAR(ws.profile.improvements);
+        return true;
+    }
+
+    // Parte del hilo t (de `threads`) en la generacion `generation` por lotes:
+    // el candidato de Levy de cada uno de sus nidos, su evaluacion por bloques
+    // y su reparacion. El candidato del nido i usa su propio subflujo, asi el
+    // resultado no depende del numero de hilos.
+    void buildCandidates(SearchWorkspace& ws, int t, int threads, uint32_t rep, int generation) {
+        PopulationArena& arena = ws.arena;
+        BatchLane& lane = *ws.lanes[t];
+        const unsigned long long allocations_before = heap_allocations;
+        PhaseLap lap(lane.profile);
+        const int begin = n_nests * t / threads, end = n_nests * (t + 1) / threads;
+        const uint64_t key = generationKey(seed, generation);
+        for (int i = begin; i < end; ++i) {
+            Philox4x32 gen(key, stream, rep, static_cast<uint32_t>(i) + 1);
+            if (levy_mode == LevyMode::Sparse) lane.sparse_levy.step(arena.nest(i), arena.candidate(i), n_items, gen);
+            else lane.levy.step(arena.nest(i), arena.candidate(i), n_items, alfa, gen);
+        }
+        lap.mark(PHASE_LEVY);
+        evaluateCandidates(arena, begin, end);
+        for (int i = begin; i < end; ++i) {
+            if (repair_enabled) repair(arena.candidate(i), arena.candidateWeight(i), arena.candidateValue(i));
+            arena.candidate_fitness[i] = fitnessFromTotals(arena.candidateWeight(i), arena.candidateValue(i));
+        }
+        CSA_SUMAR(lane.profile.evaluations, end - begin);
+        lap.mark(PHASE_EVAL);
+        lane.allocations += heap_allocations - allocations_before;
+    }
+
+    // Equipo del modo por lotes de `ws`: se crea la primera vez (o si cambio
+    // su tamano) y despues solo se reutiliza, asi las repeticiones no crean
+    // ni unen hilos. Vive hasta que se destruye el solver.
+    WorkerTeam& batchTeam(SearchWorkspace& ws) {
+        const int team_size = batchTeamSize();
+        while (static_cast<int>(ws.lanes.size()) < team_size) ws.lanes.push_back(std::make_unique<BatchLane>(alfa, beta));
+        if (!ws.team || ws.team->size() != team_size) {
+            ws.team.reset();
+            ws.team = std::make_unique<WorkerTeam>(team_size, [this, &ws, team_size](int t) {
+                buildCandidates(ws, t, team_size, ws.team_rep, ws.team_generation);
+            });
+        }
+        return *ws.team;
+    }
+
+    // Una generacion por lotes: el equipo construye y evalua los N candidatos
+    // (buildCandidates) y despues, en orden, el candidato i reemplaza a un
+    // nido aleatorio j != i si lo mejora; el mejor y el abandono de los
+    // peores se actualizan una sola vez por generacion
+    bool batchGeneration(SearchWorkspace& ws, long long& best_fitness, WorkerTeam& team) {
+        PopulationArena& arena = ws.arena;
+        team.run();
+        PhaseLap lap(ws.profile);
+
+        std::uniform_int_distribution<> nest_dis(0, n_nests - 1);
+        for (int i = 0; i < n_nests; ++i) {
+            int j;
+            do {
+                j = nest_dis(ws.gen);
+            } while (j == i);
+            if (arena.candidate_fitness[i] > arena.fitness_values[j]) {
+                arena.acceptCandidate(j, i);
+                arena.fitness_values[j] = arena.candidate_fitness[i];
+                arena.ranking.update(j);
+                CSA_CONTAR(ws.profile.accepted);
+            }
+        }
+        bool improved = trackBest(ws, best_fitness);
+        lap.mark(PHASE_SELECT);
+
+        replaceWorst(ws);
+        lap.mark(PHASE_REPLACE);
+        return improved;
+    }
+
+    // Reemplaza los pa * n_nests peores nidos sin ordenar toda la poblacion
+    void replaceWorst(SearchWorkspace& ws) {
+        PopulationArena& arena = ws.arena;
+        int num_replacements = replacementsPerIteration();
+        std::vector<int>& worst = arena.order;
+        arena.ranking.worst(num_replacements, worst);
+        for (int idx : worst) {
+            regenerateNest(ws, idx);
+            arena.ranking.release(idx);
+        }
+    }
+
+    // Una ejecucion completa (repeticion `rep`) sobre el espacio de trabajo dado
+    RunResult runOnce(SearchWorkspace& ws, int rep) {
+        ws.trace.clear();
+        ws.trace.reserve(max_iter + 1);
+        auto start = std::chrono::high_resolution_clock::now();
+        ws.reseed(seed, stream, static_cast<uint32_t>(rep));
+        ws.telemetry.begin(stream, static_cast<uint32_t>(rep), 0);
+        ws.profile = PhaseProfile();
+        PhaseLap init_lap(ws.profile);
+        long long best_fitness = initPopulation(ws, batch_enabled ? n_nests : 1);
+        init_lap.mark(PHASE_INIT);
+
+        auto best_time = std::chrono::high_resolution_clock::now();
+        ws.trace.push_back({std::chrono::duration<double>(best_time - start).count(), best_fitness});
+        ws.telemetry.step(0, best_fitness, true, start);
+
+        // Modo por lotes: el equipo del espacio de trabajo, ligado a esta repeticion
+        int iteration = 0, last_improvement = 0;
+        WorkerTeam* team = nullptr;
+        if (batch_enabled) {
+            team = &batchTeam(ws);
+            ws.team_rep = static_cast<uint32_t>(rep);
+            for (int t = 0; t < team->size(); ++t) {
+                ws.lanes[t]->profile = PhaseProfile();
+                ws.lanes[t]->allocations = 0;
+            }
+        }
+
+        unsigned long long allocations_before = heap_allocations;
+        for (; iteration < max_iter; ++iteration) {
+            double elapsed = stop_policy.needsClock()
+                ? std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count() : 0.0;
+            if (stop_policy.shouldStop(best_fitness, iteration - last_improvement, elapsed, evaluationsAfter(iteration))) break;
+            ws.team_generation = iteration;
+            bool improved = team ? batchGeneration(ws, best_fitness, *team) : cuckooIteration(ws, best_fitness);
+            if (improved) {
+                best_time = std::chrono::high_resolution_clock::now();
+                ws.trace.push_back({std::chrono::duration<double>(best_time - start).count(), best_fitness});
+                last_improvement = iteration + 1;
+            }
+            ws.telemetry.step(iteration + 1, best_fitness, improved, start);
+        }
+        unsigned long long hot_allocations = heap_allocations - allocations_before;
+
+        auto end = std::chrono::high_resolution_clock::now();
+        if (team) {
+            // Los hilos del equipo suman su tiempo de CPU al perfil y sus
+            // reservas a hot_allocs (las del carril 0, el hilo que llama, ya
+            // estan en heap_allocations)
+            for (int t = 0; t < team->size(); ++t) ws.profile.merge(ws.lanes[t]->profile);
+            for (int t = 1; t < team->size(); ++t) hot_allocations += ws.lanes[t]->allocations;
+        }
+        ws.telemetry.end(iteration, best_fitness, start);
+        RunResult result;
+        result.best_fitness = best_fitness;
+        result.seconds = std::chrono::duration<double>(end - start).count();
+        result.hot_loop_allocations = hot_allocations;
+        result.time_to_best = std::chrono::duration<double>(best_time - start).count();
+        result.keepTrace(ws.trace);
+        result.stop_iteration = iteration;
+        result.profile = ws.profile;
+        return result;
+    }
+
+    // Modo islas: K poblaciones evolucionan a la vez en K hilos. Cada
+    // `migration_interval` iteraciones cada isla envia sus mejores nidos a
+    // otra (anillo o destino aleatorio) por buzones sin bloqueos, y recibe los
+    // que le hayan llegado reemplazando a sus peores nidos. El mejor global se
+    // publica de forma atomica. Usa los espacios de trabajo
+    // [first_workspace, first_workspace + K); la isla k de la repeticion r
+    // usa el flujo (islandKey(semilla, k), stream, r). El criterio de parada
+    // se evalua sobre el mejor global en cada migracion: la isla 0 decide
+    // entre las dos barreras y todas se detienen en la misma iteracion.
+    RunResult islandSearch(const IslandOptions& opt, int rep, int first_workspace = 0) {
+        const int K = std::max(1, opt.islands);
+        const int migrants = std::max(0, std::min(opt.migrants, n_nests - 1));
+        prepareWorkspaces(first_workspace + K);
+        std::vector<std::unique_ptr<MigrantMailbox>> mailboxes(static_cast<size_t>(K) * K);
+        for (auto& box : mailboxes) box = std::make_unique<MigrantMailbox>(2 * std::max(1, migrants), n_words, dims);
+        auto mailbox = [&](int from, int to) -> MigrantMailbox& { return *mailboxes[static_cast<size_t>(from) * K + to]; };
+
+        EpochBarrier barrier(K);
+        std::atomic<bool> stop(false);
+        std::atomic<int> stop_iteration(max_iter);
+        std::atomic<long long> global_best(0);
+        std::atomic<long long> global_best_ns(0);
+        std::vector<unsigned long long> allocations(K, 0);
+        auto start = std::chrono::high_resolution_clock::now();
+
+        auto publish = [&](long long fitness) {
+            long long prev = global_best.load(std::memory_order_relaxed);
+            while (fitness > prev && !global_best.compare_exchange_weak(prev, fitness, std::memory_order_acq_rel)) {
+            }
+            if (fitness > prev) {
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::high_resolution_clock::now() - start).count();
+                global_best_ns.store(ns, std::memory_order_relaxed);
+            }
+        };
+
+        auto island = [&](int k) {
+            SearchWorkspace& ws = *workspaces[first_workspace + k];
+            PopulationArena& arena = ws.arena;
+            ws.trace.clear();
+            ws.trace.reserve(max_iter + 1);
+            ws.reseed(islandKey(seed, k), stream, static_cast<uint32_t>(rep));
+            ws.telemetry.begin(stream, static_cast<uint32_t>(rep), static_cast<uint32_t>(k));
+            ws.profile = PhaseProfile();
+            PhaseLap init_lap(ws.profile);
+            long long best_fitness = initPopulation(ws);
+            init_lap.mark(PHASE_INIT);
+            auto record = [&]() {
+                double t = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+                ws.trace.push_back({t, best_fitness});
+                publish(best_fitness);
+            };
+            record();
+            ws.telemetry.step(0, best_fitness, true, start);
+            std::uniform_int_distribution<> other_dis(0, std::max(0, K - 2));
+
+            // Estado del criterio de parada (solo lo usa la isla 0)
+            long long seen_best = global_best.load();
+            int last_improvement = 0;
+            auto decideStop = [&](int done) {
+                long long now = global_best.load();
+                if (now > seen_best) {
+                    seen_best = now;
+                    last_improvement = done;
+                }
+                double elapsed = stop_policy.needsClock()
+                    ? std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count() : 0.0;
+                if (stop_policy.shouldStop(now, done - last_improvement, elapsed, K * evaluationsAfter(done))) {
+                    stop_iteration.store(done);
+                    stop.store(true);
+                }
+            };
+
+            unsigned long long allocations_before = heap_allocations;
+            int iteration = 0;
+            for (; iteration < max_iter; ++iteration) {
+                if (K == 1) {
+                    decideStop(iteration);
+                    if (stop.load()) break;
+                }
+                bool improved = cuckooIteration(ws, best_fitness);
+                if (improved) record();
+                ws.telemetry.step(iteration + 1, best_fitness, improved, start);
+                if (K == 1 || (iteration + 1) % opt.migration_interval != 0) continue;
+                // Incluye la espera en las barreras
+                PhaseLap lap(ws.profile);
+
+                // Emigrar: los `migrants` mejores nidos
+                int to = (k + 1) % K;
+                if (opt.topology == Topology::Random) {
+                    to = other_dis(ws.gen);
+                    if (to >= k) to++;
+                }
+                std::vector<int>& ranked = arena.ranked;
+                std::iota(ranked.begin(), ranked.end(), 0);
+                std::partial_sort(ranked.begin(), ranked.begin() + migrants, ranked.end(),
+                                  [&](int a, int b) { return arena.fitness_values[a] > arena.fitness_values[b]; });
+                for (int m = 0; m < migrants; ++m) {
+                    int idx = ranked[m];
+                    mailbox(k, to).push(arena.nest(idx), arena.weight(idx), arena.value(idx));
+                }
+                barrier.arriveAndWait();
+                if (k == 0) decideStop(iteration + 1);
+
+                // Inmigrar: el recien llegado entra en la fila libre y, si mejora
+                // al peor nido, lo reemplaza intercambiando filas
+                for (int from = 0; from < K; ++from) {
+                    if (from == k) continue;
+                    while (mailbox(from, k).pop(arena.candidate(), arena.candidateWeight(), arena.candidateValue())) {
+                        long long fitness = fitnessFromTotals(arena.candidateWeight(), arena.candidateValue());
+                        if (memoActive()) arena.candidateHash() = zobristHash(arena.candidate());
+                        arena.ranking.worst(1, arena.order);
+                        int w = arena.order[0];
+                        if (fitness > arena.fitness_values[w]) {
+                            arena.acceptCandidate(w);
+                            arena.fitness_values[w] = fitness;
+                        }
+                        arena.ranking.release(w);
+                        if (fitness > best_fitness) {
+                            best_fitness = fitness;
+                            arena.saveBest(arena.ranking.best());
+                            record();
+                            CSA_CONTAR(ws.profile.improvements);
+                        }
+                    }
+                }
+                barrier.arriveAndWait();
+                lap.mark(PHASE_MIGRATE);
+                if (stop.load()) {
+                    iteration++;
+                    break;
+                }
+            }
+            allocations[k] = heap_allocations - allocations_before;
+            ws.telemetry.end(iteration, best_fitness, start);
+        };
+
+        std::vector<std::thread> threads;
+        for (int k = 1; k < K; ++k) threads.emplace_back(island, k);
+        island(0);
+        for (std::thread& t : threads) t.join();
+
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> duration = end - start;
+        RunResult result;
+        result.best_fitness = global_best.load();
+        result.seconds = duration.count();
+        result.hot_loop_allocations = std::accumulate(allocations.begin(), allocations.end(), 0ULL);
+        result.time_to_best = global_best_ns.load() * 1e-9;
+        result.stop_iteration = stop_iteration.load();
+        // Historial global: la cola (RunResult::trace) de las mejoras de
+        // todas las islas en orden de tiempo, quedandose solo con las que
+        // superan al maximo acumulado. El primer instante factible es el de
+        // la isla que llego antes.
+        const long long cutoff = withinOnePercent(result.best_fitness);
+        for (int k = 0; k < K; ++k) {
+            result.profile.merge(workspaces[first_workspace + k]->profile);
+            for (const Improvement& imp : workspaces[first_workspace + k]->trace) {
+                if (imp.fitness > 0 && (result.time_to_feasible < 0 || imp.seconds < result.time_to_feasible))
+                    result.time_to_feasible = imp.seconds;
+                if (imp.fitness >= cutoff) result.trace.push_back(imp);
+            }
+        }
+        std::sort(result.trace.begin(), result.trace.end(),
+                  [](const Improvement& a, const Improvement& b) { return a.seconds < b.seconds; });
+        size_t kept = 0;
+        for (const Improvement& imp : result.trace) {
+            if (kept == 0 || imp.fitness > result.trace[kept - 1].fitness) result.trace[kept++] = imp;
+        }
+        result.trace.resize(kept);
+        return result;
+    }
+};
+
+// ===================== Solver exacto por programacion dinamica =====================
+// Resultado de un solver exacto (solo instancias de una restriccion)
+struct ExactResult {
+    bool solved = false;     // false si la instancia excede el limite del solver
+    long long value = 0;     // valor optimo
+    long long weight = 0;    // peso de la solucion reconstruida
+    std::vector<int> chosen; // indices de los items de la solucion optima
+    double seconds = 0.0;
+    unsigned long long nodes = 0; // celdas, nodos o subconjuntos visitados
+    const char* engine = "";
+};
+
+// Limite de celdas n * capacidad que se aceptan en el barrido, y de entradas
+// por tabla: la reconstruccion guarda dos tablas de capacidad + 1 (1 GB en total)
+const double DP_MAX_CELLS = 2e9;
+const double DP_MAX_WIDTH = 1 << 26;
+
+// Mochila 0/1 exacta en O(n * C) tiempo y O(C) memoria. El valor sale de un
+// unico vector rodante; los items elegidos se reconstruyen por divide y
+// venceras (Hirschberg): se parte la lista por la mitad, se calcula la tabla
+// de cada mitad, se busca el reparto de capacidad c + (C - c) que da el
+// optimo y se resuelve cada mitad con su parte. Como las capacidades de un
+// nivel suman C y las mitades se achican, el total sigue siendo O(n * C).
+class DPKnapsackSolver {
+private:
+    const ItemStore& items;
+    std::vector<long long> left, right; // tablas de trabajo reutilizadas
+    unsigned long long cells = 0;
+
+    // table[c] = mejor valor con los items [lo, hi) y peso <= c
+    void fillTable(int lo, int hi, int cap, std::vector<long long>& table) {
+        cells += static_cast<unsigned long long>(hi - lo) * (cap + 1);
+        table.assign(cap + 1, 0);
+        long long* f = table.data();
+        for (int i = lo; i < hi; ++i) {
+            const int w = items.weight(i);
+            const long long v = items.value(i);
+            for (int c = cap; c >= w; --c) f[c] = std::max(f[c], f[c - w] + v);
+        }
+    }
+
+    void reconstruct(int lo, int hi, int cap, std::vector<int>& chosen) {
+        if (hi - lo == 1) {
+            if (items.weight(lo) <= cap && items.value(lo) > 0) chosen.push_back(lo);
+            return;
+        }
+        int mid = lo + (hi - lo) / 2;
+        fillTable(lo, mid, cap, left);
+        fillTable(mid, hi, cap, right);
+        int split = 0;
+        long long best = -1;
+        for (int c = 0; c <= cap; ++c) {
+            long long v = left[c] + right[cap - c];
+            if (v > best) {
+                best = v;
+                split = c;
+            }
+        }
+        reconstruct(lo, mid, split, chosen);
+        reconstruct(mid, hi, cap - split, chosen);
+    }
+
+public:
+    explicit DPKnapsackSolver(const ItemStore& items) : items(items) {}
+
+    static bool fits(const ItemStore& items) {
+        const double width = static_cast<double>(items.capacity()) + 1;
+        return width <= DP_MAX_WIDTH && static_cast<double>(items.size()) * width <= DP_MAX_CELLS;
+    }
+
+    // Valor optimo y solucion reconstruida
+    ExactResult solve() {
+        auto start = std::chrono::high_resolution_clock::now();
+        const int capacity = static_cast<int>(items.capacity());
+        ExactResult result;
+        result.solved = true;
+        result.engine = "dp";
+        cells = 0;
+        if (items.size() > 0 && capacity >= 0) reconstruct(0, static_cast<int>(items.size()), capacity, result.chosen);
+        std::sort(result.chosen.begin(), result.chosen.end());
+        for (int i : result.chosen) {
+            result.weight += items.weight(i);
+            result.value += items.value(i);
+        }
+        result.nodes = cells;
+        result.seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        return result;
+    }
+};
+
+// ===================== Ramificacion y acotacion / meet in the middle =====================
+// Limite de nodos del branch and bound por presupuesto de memoria: cada nodo
+// guarda 8 bytes para siempre (padre, nivel y si tomo el item) y, mientras
+// esta abierto, 32 bytes en el monticulo (cota, peso, valor e indice). En el
+// peor caso todos estan abiertos: 40 bytes por nodo, ~13 millones en 512 MB.
+// BB_PROBE_NODES es el presupuesto del primer intento en la eleccion automatica.
+const unsigned long long BB_MAX_BYTES = 512ULL << 20;
+const unsigned long long BB_BYTES_PER_NODE = 8 + 32;
+const unsigned long long BB_MAX_NODES = BB_MAX_BYTES / BB_BYTES_PER_NODE;
+const unsigned long long BB_PROBE_NODES = 1000000ULL;
+// La mitad enumerada y guardada del meet in the middle tiene 2^(n/2) entradas
+const int MITM_MAX_ITEMS = 44;
+
+// Branch and bound primero-el-mejor. Los items se ordenan por valor/peso y la
+// cota de cada nodo es la relajacion fraccionaria de Dantzig: se llenan los
+// items restantes en orden y se toma una fraccion del primero que no cabe.
+// Con sumas prefijas ese item critico se encuentra por busqueda binaria.
+class BranchAndBoundSolver {
+private:
+    // Lo que se guarda de cada nodo para reconstruir la solucion
+    struct Node {
+        int parent;          // nodo padre en el arbol (-1 en la raiz)
+        uint32_t level : 31; // siguiente item (en orden de ratio) por decidir
+        uint32_t take : 1;   // si este nodo tomo el item level - 1
+    };
+    // Nodo abierto: su peso y valor solo hacen falta hasta expandirlo
+    struct OpenNode {
+        double bound;
+        long long weight;
+        long long value;
+        int id;
+        bool operator<(const OpenNode& o) const { return bound < o.bound || (bound == o.bound && id < o.id); }
+    };
+    static_assert(sizeof(Node) + sizeof(OpenNode) == BB_BYTES_PER_NODE, "presupuesto de nodos desactualizado");
+
+    const ItemStore& items;
+    std::vector<int> order;                    // indices por ratio decreciente
+    std::vector<long long> prefix_w, prefix_v; // sumas prefijas en ese orden
+    std::vector<Node> nodes;
+
+    // Cota de Dantzig de un nodo en `level` con ese peso y valor; `all_fit`
+    // indica que todos los restantes caben
+    double bound(int level, long long weight, long long value, long long capacity, bool& all_fit) const {
+        const int n = static_cast<int>(order.size());
+        long long room = capacity - weight + prefix_w[level];
+        // Primer k > level con prefix_w[k] > room: el item k - 1 es el critico
+        int k = static_cast<int>(std::upper_bound(prefix_w.begin() + level + 1, prefix_w.end(), room) - prefix_w.begin());
+        all_fit = (k > n);
+        if (all_fit) return static_cast<double>(value + prefix_v[n] - prefix_v[level]);
+        const int critical = order[k - 1];
+        double whole = static_cast<double>(value + prefix_v[k - 1] - prefix_v[level]);
+        double left = static_cast<double>(room - prefix_w[k - 1]);
+        return whole + left * items.value(critical) / items.weight(critical);
+    }
+
+    void collect(int node, std::vector<int>& chosen) const {
+        for (; node > 0; node = nodes[node].parent) {
+            if (nodes[node].take) chosen.push_back(order[nodes[node].level - 1]);
+        }
+    }
+
+public:
+    explicit BranchAndBoundSolver(const ItemStore& items) : items(items) {}
+
+    ExactResult solve(unsigned long long max_nodes = BB_MAX_NODES) {
+        auto start = std::chrono::high_resolution_clock::now();
+        const long long capacity = items.capacity();
+        const int n = static_cast<int>(items.size());
+        order.resize(n);
+        std::iota(order.begin(), order.end(), 0);
+        // Items de peso 0 primero (ratio infinito)
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+            if (items.weight(a) == 0 || items.weight(b) == 0) return items.weight(a) == 0 && items.weight(b) != 0;
+            return static_cast<long long>(items.value(a)) * items.weight(b) > static_cast<long long>(items.value(b)) * items.weight(a);
+        });
+        prefix_w.assign(n + 1, 0);
+        prefix_v.assign(n + 1, 0);
+        for (int t = 0; t < n; ++t) {
+            prefix_w[t + 1] = prefix_w[t] + items.weight(order[t]);
+            prefix_v[t + 1] = prefix_v[t] + items.value(order[t]);
+        }
+
+        ExactResult result;
+        result.engine = "bb";
+        // Incumbente inicial: voraz por ratio saltando los que no caben
+        long long greedy_w = 0, incumbent = 0;
+        std::vector<int> incumbent_items;
+        for (int t = 0; t < n; ++t) {
+            const int it = order[t];
+            if (greedy_w + items.weight(it) <= capacity) {
+                greedy_w += items.weight(it);
+                incumbent += items.value(it);
+                incumbent_items.push_back(it);
+            }
+        }
+        int incumbent_node = -1;
+        int incumbent_fill = -1; // si >= 0, el incumbente anade todos los items desde este nivel
+
+        nodes.clear();
+        nodes.push_back({-1, 0, 0});
+        std::priority_queue<OpenNode> open;
+        bool all_fit;
+        open.push({bound(0, 0, 0, capacity, all_fit), 0, 0, 0});
+        bool exhausted = true;
+        while (!open.empty()) {
+            const OpenNode node = open.top();
+            open.pop();
+            if (node.bound < incumbent + 1) break; // ningun nodo abierto puede mejorar
+            result.nodes++;
+            const int level = nodes[node.id].level;
+            if (level == n) continue;
+            if (nodes.size() + 2 > max_nodes) {
+                exhausted = false;
+                break;
+            }
+            const int it = order[level];
+            // Primero el hijo que toma el item, como antes
+            for (int take = 1; take >= 0; --take) {
+                const long long weight = node.weight + (take ? items.weight(it) : 0);
+                const long long value = node.value + (take ? items.value(it) : 0);
+                if (weight > capacity) continue;
+                double b = bound(level + 1, weight, value, capacity, all_fit);
+                if (b < incumbent + 1) continue;
+                int child_id = static_cast<int>(nodes.size());
+                nodes.push_back({node.id, static_cast<uint32_t>(level + 1), static_cast<uint32_t>(take)});
+                if (all_fit) {
+                    // La cota es alcanzable: el nodo con todos los restantes
+                    incumbent = static_cast<long long>(b);
+                    incumbent_node = child_id;
+                    incumbent_fill = level + 1;
+                    continue;
+                }
+                if (value > incumbent) {
+                    incumbent = value;
+                    incumbent_node = child_id;
+                    incumbent_fill = -1;
+                }
+                open.push({b, weight, value, child_id});
+            }
+        }
+
+        result.solved = exhausted;
+        if (incumbent_node >= 0) {
+            incumbent_items.clear();
+            collect(incumbent_node, incumbent_items);
+            if (incumbent_fill >= 0) {
+                for (int t = incumbent_fill; t < n; ++t) incumbent_items.push_back(order[t]);
+            }
+        }
+        result.chosen = std::move(incumbent_items);
+        std::sort(result.chosen.begin(), result.chosen.end());
+        for (int i : result.chosen) {
+            result.weight += items.weight(i);
+            result.value += items.value(i);
+        }
+        nodes.clear();
+        nodes.shrink_to_fit();
+        result.seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        return result;
+    }
+};
+
+// Meet in the middle: se enumeran los 2^n2 subconjuntos de la segunda mitad,
+// se ordenan por peso y se dejan solo los no dominados (valor estrictamente
+// creciente); luego los 2^n1 subconjuntos de la primera mitad se recorren en
+// orden Gray (un item entra o sale por paso) y cada uno busca por busqueda
+// binaria el mejor complemento que cabe.
+class MeetInTheMiddleSolver {
+private:
+    struct Subset {
+        long long weight;
+        long long value;
+        uint32_t mask;
+    };
+
+    const ItemStore& items;
+
+public:
+    explicit MeetInTheMiddleSolver(const ItemStore& items) : items(items) {}
+
+    static bool fits(const ItemStore& items) { return static_cast<int>(items.size()) <= MITM_MAX_ITEMS; }
+
+    ExactResult solve() {
+        auto start = std::chrono::high_resolution_clock::now();
+        const long long capacity = items.capacity();
+        const int n = static_cast<int>(items.size());
+        const int n2 = n / 2, n1 = n - n2;
+        ExactResult result;
+        result.engine = "mitm";
+        result.solved = true;
+
+        // Segunda mitad: lista por duplicacion (cada item copia la lista sumandose)
+        std::vector<Subset> half;
+        half.reserve(size_t(1) << n2);
+        half.push_back({0, 0, 0});
+        for (int t = 0; t < n2; ++t) {
+            const int w = items.weight(n1 + t), v = items.value(n1 + t);
+            size_t count = half.size();
+            for (size_t s = 0; s < count; ++s) {
+                half.push_back({half[s].weight + w, half[s].value + v, half[s].mask | (1u << t)});
+            }
+        }
+        result.nodes += half.size();
+        std::sort(half.begin(), half.end(), [](const Subset& a, const Subset& b) {
+            return a.weight < b.weight || (a.weight == b.weight && a.value > b.value);
+        });
+        size_t kept = 0;
+        for (const Subset& s : half) {
+            if (kept == 0 || s.value > half[kept - 1].value) half[kept++] = s;
+        }
+        half.resize(kept);
+
+        // Primera mitad en orden Gray
+        long long w = 0, v = 0, best = -1;
+        uint64_t mask = 0, best_mask = 0;
+        uint32_t best_other = 0;
+        const uint64_t total = 1ULL << n1;
+        for (uint64_t g = 0; g < total; ++g) {
+            if (g > 0) {
+                int t = lowestBit(g);
+                mask ^= 1ULL << t;
+                if (mask >> t & 1) {
+                    w += items.weight(t);
+                    v += items.value(t);
+                } else {
+                    w -= items.weight(t);
+                    v -= items.value(t);
+                }
+            }
+            if (w > capacity) continue;
+            long long room = capacity - w;
+            auto it = std::upper_bound(half.begin(), half.end(), room, [](long long r, const Subset& s) { return r < s.weight; });
+            const Subset& other = *(it - 1); // el subconjunto vacio siempre cabe
+            if (v + other.value > best) {
+                best = v + other.value;
+                best_mask = mask;
+                best_other = other.mask;
+            }
+        }
+        result.nodes += total;
+
+        for (int t = 0; t < n1; ++t) {
+            if (best_mask >> t & 1) result.chosen.push_back(t);
+        }
+        for (int t = 0; t < n2; ++t) {
+            if (best_other >> t & 1) result.chosen.push_back(n1 + t);
+        }
+        for (int i : result.chosen) {
+            result.weight += items.weight(i);
+            result.value += items.value(i);
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        return result;
+    }
+};
+
+enum class ExactEngine { Auto, None, DP, BranchAndBound, MeetInTheMiddle };
+
+// Los solvers exactos solo cubren la mochila de una restriccion; con D > 1
+// el resultado queda sin resolver (columnas vacias)
+ExactResult solveExact(const ItemStore& items, ExactEngine engine) {
+    if (items.dimensions() != 1) return ExactResult{};
+    switch (engine) {
+    case ExactEngine::DP: {
+        if (!DPKnapsackSolver::fits(items)) return ExactResult{};
+        DPKnapsackSolver dp(items);
+        return dp.solve();
+    }
+    case ExactEngine::BranchAndBound: {
+        BranchAndBoundSolver bb(items);
+        return bb.solve();
+    }
+    case ExactEngine::MeetInTheMiddle: {
+        if (!MeetInTheMiddleSolver::fits(items)) return ExactResult{};
+        MeetInTheMiddleSolver mitm(items);
+        return mitm.solve();
+    }
+    case ExactEngine::Auto:
+        break;
+    default:
+        return ExactResult{};
+    }
+
+    // Eleccion automatica: primero un branch and bound con presupuesto corto
+    // (resuelve en milisegundos las instancias poco correlacionadas); si no
+    // termina, el DP o el meet in the middle, el que cueste menos de los que
+    // quepan. Si ninguno cabe, el branch and bound sigue con el limite completo.
+    const double n = static_cast<double>(items.size());
+    const int n2 = static_cast<int>(items.size()) / 2;
+    const double dp_cost = 2.0 * n * (static_cast<double>(items.capacity()) + 1);
+    const double mitm_cost = std::ldexp(n - n2, static_cast<int>(items.size()) - n2) + std::ldexp(n2 + 1.0, n2);
+    const bool dp_fits = DPKnapsackSolver::fits(items);
+    const bool mitm_fits = MeetInTheMiddleSolver::fits(items);
+
+    BranchAndBoundSolver bb(items);
+    ExactResult probe = bb.solve((dp_fits || mitm_fits) ? BB_PROBE_NODES : BB_MAX_NODES);
+    if (probe.solved || !(dp_fits || mitm_fits)) return probe;
+
+    bool use_mitm = mitm_fits && (!dp_fits || mitm_cost < dp_cost);
+    ExactResult result = solveExact(items, use_mitm ? ExactEngine::MeetInTheMiddle : ExactEngine::DP);
+    result.engine = use_mitm ? "bb+mitm" : "bb+dp";
+    result.seconds += probe.seconds;
+    result.nodes += probe.nodes;
+    return result;
+}
+
+// ===================== Carga de instancias =====================
+// Archivo de solo lectura proyectado en memoria (mmap). En Windows se lee
+// completo a un bufer con fread.
+class MappedFile {
+private:
+    const char* bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    std::vector<char> buffer;
+#endif
+
+public:
+    explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) return;
+        std::fseek(file, 0, SEEK_END);
+        long end = std::ftell(file);
+        std::fseek(file, 0, SEEK_SET);
+        if (end > 0) {
+            buffer.resize(static_cast<size_t>(end));
+            length = std::fread(buffer.data(), 1, buffer.size(), file);
+            bytes = buffer.data();
+        }
+        std::fclose(file);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat info;
+        if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+#ifdef MAP_POPULATE
+            const int flags = MAP_PRIVATE | MAP_POPULATE; // se recorre entero: mejor cargarlo de una vez
+#else
+            const int flags = MAP_PRIVATE;
+#endif
+            void* map = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, flags, fd, 0);
+            if (map != MAP_FAILED) {
+                bytes = static_cast<const char*>(map);
+                length = static_cast<size_t>(info.st_size);
+                ::madvise(map, length, MADV_SEQUENTIAL);
+            }
+        }
+        ::close(fd);
+#endif
+    }
+    ~MappedFile() {
+#ifndef _WIN32
+        if (bytes) ::munmap(const_cast<char*>(bytes), length);
+#endif
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool ok() const { return bytes != nullptr; }
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+};
+
+// Instancia leida de un archivo, en el formato que recibe ItemStore
+struct InstanceData {
+    std::vector<int> values;
+    std::vector<int> weights;           // D filas de n pesos seguidas
+    std::vector<long long> capacities;  // una por restriccion
+    long long known_optimum = -1;       // optimo publicado en el archivo (-1 si no viene)
+};
+
+// Lector de enteros sobre el texto proyectado, sin crear cadenas: salta todo
+// lo que no sea un numero y parsea los digitos en el sitio
+class InstanceScanner {
+private:
+    const char* p;
+    const char* end;
+
+public:
+    InstanceScanner(const char* begin, const char* finish) : p(begin), end(finish) {}
+
+    static bool digit(char c) { return static_cast<unsigned char>(c - '0') < 10; }
+
+    bool next(long long& out) {
+        const char* q = p; // copia local: el compilador la mantiene en registro
+        while (q < end && !digit(*q) && !(*q == '-' && q + 1 < end && digit(q[1]))) ++q;
+        if (q >= end) {
+            p = q;
+            return false;
+        }
+        bool negative = (*q == '-');
+        if (negative) ++q;
+        long long v = 0;
+        while (q < end && digit(*q)) v = v * 10 + (*q++ - '0');
+        // Parte decimal (p. ej. "time 0.00"): se descarta
+        if (q < end && *q == '.') {
+            ++q;
+            while (q < end && digit(*q)) ++q;
+        }
+        p = q;
+        out = negative ? -v : v;
+        return true;
+    }
+    bool nextInt(int& out) {
+        long long v;
+        if (!next(v) || v < std::numeric_limits<int>::min() || v > std::numeric_limits<int>::max()) return false;
+        out = static_cast<int>(v);
+        return true;
+    }
+
+    void skipBlanks() {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) ++p;
+    }
+    // Avanza hasta pasar el siguiente `c` (o hasta el final)
+    void skipPast(char c) {
+        const void* found = std::memchr(p, c, static_cast<size_t>(end - p));
+        p = found ? static_cast<const char*>(found) + 1 : end;
+    }
+    void skipLine() { skipPast('\n'); }
+    // Cuantos numeros hay en lo que queda de la linea actual (sin avanzar)
+    int numbersInLine() const {
+        int count = 0;
+        bool in_number = false;
+        for (const char* q = p; q < end && *q != '\n'; ++q) {
+            bool digit = (*q >= '0' && *q <= '9') || *q == '.' || *q == '-';
+            if (digit && !in_number) ++count;
+            in_number = digit;
+        }
+        return count;
+    }
+    bool atEnd() const { return p >= end; }
+    char peek() const { return p < end ? *p : '\0'; }
+};
+
+// Formato de Pisinger (knapPI_*): una linea con el nombre, "n N", "c C",
+// "z Z" (optimo; 0 si no se conoce), "time T" y despues N lineas "i,valor,peso,x". Si el
+// archivo trae varias instancias se lee la primera.
+// Pesos, valores y capacidades negativos no son una mochila valida (y el DP
+// indexaria fuera de su tabla): la instancia se rechaza
+bool nonNegative(const InstanceData& data) {
+    auto negative = [](long long x) { return x < 0; };
+    return std::none_of(data.values.begin(), data.values.end(), negative) &&
+           std::none_of(data.weights.begin(), data.weights.end(), negative) &&
+           std::none_of(data.capacities.begin(), data.capacities.end(), negative);
+}
+
+bool parsePisinger(InstanceScanner& in, InstanceData& out) {
+    long long n = -1, capacity = -1;
+    in.skipLine(); // nombre
+    for (in.skipBlanks(); !in.atEnd() && !(in.peek() >= '0' && in.peek() <= '9'); in.skipBlanks()) {
+        char key = in.peek();
+        long long v = 0;
+        if (key == 'n' && in.next(v)) n = v;
+        else if (key == 'c' && in.next(v)) capacity = v;
+        else if (key == 'z' && in.next(v)) out.known_optimum = (v > 0) ? v : -1;
+        else in.skipLine();
+    }
+    if (n <= 0 || capacity < 0 || n > std::numeric_limits<int>::max()) return false;
+    out.values.resize(n);
+    out.weights.resize(n);
+    out.capacities.assign(1, capacity);
+    for (long long i = 0; i < n; ++i) {
+        // Solo interesan valor y peso: el indice y x se saltan sin parsearlos
+        in.skipPast(',');
+        if (!in.nextInt(out.values[i]) || !in.nextInt(out.weights[i])) return false;
+        in.skipLine();
+    }
+    return nonNegative(out);
+}
+
+// Formato simple: "n capacidad" y n pares "valor peso" (lo que siga, como
+// el vector solucion de algunos conjuntos, se ignora)
+bool parseSimple(InstanceScanner& in, InstanceData& out) {
+    long long n, capacity;
+    if (!in.next(n) || !in.next(capacity) || n <= 0 || capacity < 0 || n > std::numeric_limits<int>::max()) return false;
+    out.values.resize(n);
+    out.weights.resize(n);
+    out.capacities.assign(1, capacity);
+    for (long long i = 0; i < n; ++i) {
+        if (!in.nextInt(out.values[i]) || !in.nextInt(out.weights[i])) return false;
+    }
+    return nonNegative(out);
+}
+
+// OR-Library (mknap): "n m optimo", n valores, m filas de n pesos y m
+// capacidades. Los archivos con varios problemas empiezan con su numero y
+// se lee el primero. Un optimo 0 significa desconocido.
+bool parseOrLibrary(InstanceScanner& in, InstanceData& out, bool multiple) {
+    long long problems = 1, n, m, optimum;
+    if (multiple && (!in.next(problems) || problems < 1)) return false;
+    if (!in.next(n) || !in.next(m) || !in.next(optimum)) return false;
+    if (n <= 0 || m <= 0 || n * m > std::numeric_limits<int>::max()) return false;
+    out.values.resize(n);
+    out.weights.resize(n * m);
+    out.capacities.resize(m);
+    for (long long i = 0; i < n; ++i) {
+        if (!in.nextInt(out.values[i])) return false;
+    }
+    for (long long k = 0; k < n * m; ++k) {
+        if (!in.nextInt(out.weights[k])) return false;
+    }
+    for (long long d = 0; d < m; ++d) {
+        if (!in.next(out.capacities[d])) return false;
+    }
+    out.known_optimum = (optimum > 0) ? optimum : -1;
+    return nonNegative(out);
+}
+
+// Tamano y fecha de modificacion (en ns) del archivo de texto del que sale
+// una cache; todo en cero si no hay archivo de texto (instancia generada)
+struct SourceStamp {
+    uint64_t size = 0;
+    int64_t mtime_ns = 0;
+
+    bool operator==(const SourceStamp& o) const { return size == o.size && mtime_ns == o.mtime_ns; }
+};
+
+bool sourceStamp(const std::string& path, SourceStamp& stamp) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) return false;
+    stamp.size = static_cast<uint64_t>(st.st_size);
+#if defined(__APPLE__)
+    stamp.mtime_ns = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000LL + st.st_mtimespec.tv_nsec;
+#elif defined(_WIN32)
+    stamp.mtime_ns = static_cast<int64_t>(st.st_mtime) * 1000000000LL;
+#else
+    stamp.mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+#endif
+    return true;
+}
+
+// Cache binaria: cabecera "CSAI" (con el sello del archivo de texto de
+// origen) y despues capacidades (int64), valores y pesos (int32) tal cual
+// estan en memoria
+struct InstanceCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t n;
+    uint32_t dims;
+    uint32_t reserved;
+    int64_t known_optimum;
+    uint64_t source_size;
+    int64_t source_mtime_ns;
+};
+const uint32_t INSTANCE_CACHE_MAGIC = 0x49415343u; // "CSAI"
+const uint32_t INSTANCE_CACHE_VERSION = 2;
+
+bool readInstanceCache(const MappedFile& file, InstanceData& out, SourceStamp& stamp) {
+    InstanceCacheHeader header;
+    if (file.size() < sizeof(header)) return false;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (header.magic != INSTANCE_CACHE_MAGIC || header.version != INSTANCE_CACHE_VERSION || header.dims == 0) return false;
+    const size_t n = header.n, dims = header.dims;
+    if (file.size() != sizeof(header) + dims * sizeof(int64_t) + n * (dims + 1) * sizeof(int32_t)) return false;
+    const char* p = file.data() + sizeof(header);
+    out.capacities.resize(dims);
+    out.values.resize(n);
+    out.weights.resize(n * dims);
+    std::memcpy(out.capacities.data(), p, dims * sizeof(int64_t));
+    p += dims * sizeof(int64_t);
+    std::memcpy(out.values.data(), p, n * sizeof(int32_t));
+    p += n * sizeof(int32_t);
+    std::memcpy(out.weights.data(), p, n * dims * sizeof(int32_t));
+    out.known_optimum = header.known_optimum;
+    stamp.size = header.source_size;
+    stamp.mtime_ns = header.source_mtime_ns;
+    return nonNegative(out);
+}
+
+bool writeInstanceCache(const std::string& path, const InstanceData& data, const SourceStamp& stamp) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    InstanceCacheHeader header{INSTANCE_CACHE_MAGIC, INSTANCE_CACHE_VERSION, data.values.size(),
+                               static_cast<uint32_t>(data.capacities.size()), 0u, data.known_optimum, stamp.size, stamp.mtime_ns};
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(data.capacities.data(), sizeof(int64_t), data.capacities.size(), file) == data.capacities.size() &&
+              std::fwrite(data.values.data(), sizeof(int32_t), data.values.size(), file) == data.values.size() &&
+              std::fwrite(data.weights.data(), sizeof(int32_t), data.weights.size(), file) == data.weights.size();
+    return (std::fclose(file) == 0) && ok;
+}
+
+// Lee una instancia. El formato se reconoce por el contenido: cache binaria,
+// Pisinger (empieza con un nombre), simple (2 numeros en la primera linea)
+// u OR-Library (1 numero: cantidad de problemas; 3: un solo problema).
+// Con `use_cache`, "<ruta>.csai" se usa si su cabecera guarda exactamente el
+// tamano y la fecha de modificacion (en ns) actuales del archivo de texto, y
+// si no se reescribe tras parsearlo. El sello se toma antes de leer el
+// archivo: si cambia mientras se parsea, la cache no coincidira la proxima vez.
+bool loadInstance(const std::string& path, bool use_cache, InstanceData& out, std::string& error) {
+    const std::string cache_path = path + ".csai";
+    SourceStamp source, cached;
+    const bool stamped = sourceStamp(path, source);
+    if (use_cache && stamped) {
+        // Se lee aparte: una cache vieja no debe dejar datos en `out`
+        MappedFile file(cache_path);
+        InstanceData data;
+        if (file.ok() && readInstanceCache(file, data, cached) && cached == source) {
+            out = std::move(data);
+            return true;
+        }
+    }
+
+    MappedFile file(path);
+    if (!file.ok()) {
+        error = "no se pudo abrir";
+        return false;
+    }
+    if (readInstanceCache(file, out, cached)) return true;
+    InstanceScanner in(file.data(), file.data() + file.size());
+    bool parsed;
+    in.skipBlanks();
+    char first = in.peek();
+    if ((first >= 'a' && first <= 'z') || (first >= 'A' && first <= 'Z')) {
+        parsed = parsePisinger(in, out);
+    } else {
+        int numbers = in.numbersInLine();
+        if (numbers == 2) parsed = parseSimple(in, out);
+        else if (numbers == 1 || numbers == 3) parsed = parseOrLibrary(in, out, numbers == 1);
+        else parsed = false;
+    }
+    if (!parsed) {
+        error = "formato no reconocido, archivo incompleto o con pesos, valores o capacidades negativos";
+        return false;
+    }
+    if (use_cache && stamped && !writeInstanceCache(cache_path, out, source)) std::cerr << "No se pudo escribir " << cache_path << std::endl;
+    return true;
+}
+
+// ===================== Generador de instancias =====================
+// Familias clasicas de Pisinger con coeficientes en [1, R]:
+// - NoCorrelated: peso y valor independientes.
+// - WeaklyCorrelated: valor en [peso - R/10, peso + R/10] (al menos 1).
+// - StronglyCorrelated: valor = peso + R/10.
+// - InverseStronglyCorrelated: peso = valor + R/10.
+// - SubsetSum: valor = peso.
+// Classic es la del barrido original (peso en [1, 10], valor en [10, 100]).
+// Las restricciones extra (d > 0) tienen pesos independientes en el rango
+// de la familia.
+enum class InstanceFamily { Classic, Uncorrelated, WeaklyCorrelated, StronglyCorrelated, InverseStronglyCorrelated, SubsetSum };
+
+struct GeneratorOptions {
+    InstanceFamily family = InstanceFamily::Classic;
+    int range = 1000;             // R
+    double capacity_ratio = 0.4;  // capacidad = ratio * suma de los pesos de cada restriccion
+};
+
+// Familia por su nombre en config.txt o --generar-tipo; false si no existe
+bool parseFamily(const std::string& name, InstanceFamily& family) {
+    if (name == "clasico") family = InstanceFamily::Classic;
+    else if (name == "no_correlacionado") family = InstanceFamily::Uncorrelated;
+    else if (name == "debil") family = InstanceFamily::WeaklyCorrelated;
+    else if (name == "fuerte") family = InstanceFamily::StronglyCorrelated;
+    else if (name == "inverso") family = InstanceFamily::InverseStronglyCorrelated;
+    else if (name == "suma") family = InstanceFamily::SubsetSum;
+    else return false;
+    return true;
+}
+
+// Items uno por uno del flujo (semilla, index, STREAM_INSTANCE): la misma
+// semilla e indice dan la misma instancia en memoria y en disco. En Classic
+// se sortean el peso 0, el valor y los demas pesos, como siempre.
+class InstanceGenerator {
+private:
+    Philox4x32 gen;
+    GeneratorOptions opt;
+    int dims;
+
+    int uniform(int lo, int hi) { return std::uniform_int_distribution<>(lo, hi)(gen); }
+
+public:
+    InstanceGenerator(uint64_t seed, uint32_t index, const GeneratorOptions& options, int dimensions)
+        : gen(seed, index, STREAM_INSTANCE), opt(options), dims(dimensions) {
+        opt.range = std::max(1, opt.range);
+    }
+
+    void next(int& value, int* weights) {
+        const int R = opt.range, spread = opt.range / 10;
+        switch (opt.family) {
+        case InstanceFamily::Classic:
+            weights[0] = uniform(1, 10);
+            value = uniform(10, 100);
+            break;
+        case InstanceFamily::Uncorrelated:
+            weights[0] = uniform(1, R);
+            value = uniform(1, R);
+            break;
+        case InstanceFamily::WeaklyCorrelated:
+            weights[0] = uniform(1, R);
+            value = uniform(std::max(1, weights[0] - spread), weights[0] + spread);
+            break;
+        case InstanceFamily::StronglyCorrelated:
+            weights[0] = uniform(1, R);
+            value = weights[0] + spread;
+            break;
+        case InstanceFamily::InverseStronglyCorrelated:
+            value = uniform(1, R);
+            weights[0] = value + spread;
+            break;
+        case InstanceFamily::SubsetSum:
+            weights[0] = uniform(1, R);
+            value = weights[0];
+            break;
+        }
+        for (int d = 1; d < dims; ++d) weights[d] = uniform(1, opt.family == InstanceFamily::Classic ? 10 : R);
+    }
+
+    long long capacity(long long total_weight) const { return static_cast<long long>(opt.capacity_ratio * total_weight); }
+};
+
+// Genera la instancia directamente en un ItemStore, sin copia intermedia
+std::shared_ptr<const ItemStore> generateStore(uint64_t seed, uint32_t index, const GeneratorOptions& opt, size_t n, int dims) {
+    InstanceGenerator source(seed, index, opt, dims);
+    return std::make_shared<const ItemStore>(
+        n, dims, [&](int& value, int* weights) { source.next(value, weights); },
+        [&](int, long long total) { return source.capacity(total); });
+}
+
+inline bool seekFile(FILE* file, uint64_t offset) {
+#ifdef _WIN32
+    return _fseeki64(file, static_cast<long long>(offset), SEEK_SET) == 0;
+#else
+    return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+// Escribe la instancia en formato de cache (.csai) por bloques de
+// GENERATOR_CHUNK items: cada bloque de valores y de cada fila de pesos va a
+// su posicion en el archivo, y las capacidades (que dependen de las sumas) se
+// escriben al final. La memoria no depende de n.
+const size_t GENERATOR_CHUNK = 1 << 16;
+
+bool writeGeneratedInstance(const std::string& path, uint64_t seed, const GeneratorOptions& opt, size_t n, int dims) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    InstanceGenerator source(seed, 0, opt, dims);
+    const uint64_t values_offset = sizeof(InstanceCacheHeader) + dims * sizeof(int64_t);
+    const uint64_t weights_offset = values_offset + n * sizeof(int32_t);
+    std::vector<int> values(GENERATOR_CHUNK), weights(GENERATOR_CHUNK * dims), item(dims);
+    std::vector<long long> totals(dims, 0);
+    bool ok = true;
+    for (size_t begin = 0; begin < n && ok; begin += GENERATOR_CHUNK) {
+        const size_t count = std::min(GENERATOR_CHUNK, n - begin);
+        for (size_t i = 0; i < count; ++i) {
+            source.next(values[i], item.data());
+            for (int d = 0; d < dims; ++d) {
+                weights[d * GENERATOR_CHUNK + i] = item[d];
+                totals[d] += item[d];
+            }
+        }
+        ok = seekFile(file, values_offset + begin * sizeof(int32_t)) &&
+             std::fwrite(values.data(), sizeof(int32_t), count, file) == count;
+        for (int d = 0; d < dims && ok; ++d) {
+            ok = seekFile(file, weights_offset + (d * n + begin) * sizeof(int32_t)) &&
+                 std::fwrite(weights.data() + d * GENERATOR_CHUNK, sizeof(int32_t), count, file) == count;
+        }
+    }
+    std::vector<long long> capacities(dims);
+    for (int d = 0; d < dims; ++d) capacities[d] = source.capacity(totals[d]);
+    InstanceCacheHeader header{INSTANCE_CACHE_MAGIC, INSTANCE_CACHE_VERSION, n, static_cast<uint32_t>(dims), 0u, -1, 0u, 0};
+    ok = ok && seekFile(file, 0) && std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+         std::fwrite(capacities.data(), sizeof(int64_t), dims, file) == static_cast<size_t>(dims);
+    return (std::fclose(file) == 0) && ok;
+}
+
+// ===================== Barrido de config.txt =====================
+// Una linea de config.txt: parametros, instancia generada y resultados
+struct SweepConfig {
+    int n_items = 0;
+    int n_nests = 0;
+    int max_iter = 0;
+    int repetitions = 0;
+    int dimensions = 1; // restricciones de la mochila (D)
+    GeneratorOptions generator; // familia, rango y capacidad de la instancia generada
+    std::string instance_path; // instancia=archivo: se carga en lugar de generarla
+    bool instance_cache = false;
+    uint64_t seed = 0;
+    double density = 0.5;
+    bool repair = false;
+    bool greedy_init = false;
+    StopPolicy stop;
+    bool target_optimum = false; // objetivo=optimo: el objetivo es el optimo exacto
+    LevyMode levy_mode = LevyMode::Dense;
+    bool island_mode = false;
+    IslandOptions island;
+    bool batch = false;    // lote=si: generaciones por lotes
+    int batch_threads = 1; // hilos_lote=T
+    int memo_bits = 0;     // memo=B: cache de fitness de 2^B entradas por hilo
+    std::string invalid_option; // opcion de la linea con un valor desconocido (vacia si no hay)
+    std::unique_ptr<CuckooSearchKnapsack> solver;
+    RunsSummary summary; // repeticiones acumuladas al terminar (protegido por el mutex del barrido)
+    ExactEngine exact_engine = ExactEngine::Auto;
+    ExactResult exact; // optimo de referencia
+    int remaining = 0; // tareas sin terminar (protegido por el mutex del barrido)
+
+    // Estimacion de coste de una repeticion
+    double cost() const {
+        return static_cast<double>(n_items) * max_iter * n_nests * (island_mode ? island.islands : 1) *
+               (batch && !island_mode ? n_nests : 1);
+    }
+    // Estimacion de coste del solver exacto, en las mismas unidades (aprox.)
+    double exactCost() const { return 2.0 * n_items * (static_cast<double>(solver->getCapacity()) + 1); }
+};
+
+// "n_items n_nests max_iter repeticiones [clave=valor ...]"
+bool parseConfigLine(const std::string& line, SweepConfig& cfg) {
+    std::istringstream iss(line);
+    if (!(iss >> cfg.n_items >> cfg.n_nests >> cfg.max_iter >> cfg.repetitions)) return false;
+
+    // Opciones adicionales en formato clave=valor
+    std::string option;
+    while (iss >> option) {
+        size_t eq = option.find('=');
+        std::string key = option.substr(0, eq);
+        std::string value = (eq == std::string::npos) ? "" : option.substr(eq + 1);
+        if (key == "levy") cfg.levy_mode = (value == "disperso") ? LevyMode::Sparse : LevyMode::Dense;
+        else if (key == "modo") cfg.island_mode = (value == "islas");
+        else if (key == "islas") cfg.island.islands = std::max(1, std::atoi(value.c_str()));
+        else if (key == "migracion") cfg.island.migration_interval = std::max(1, std::atoi(value.c_str()));
+        else if (key == "migrantes") cfg.island.migrants = std::atoi(value.c_str());
+        else if (key == "topologia") cfg.island.topology = (value == "aleatoria") ? Topology::Random : Topology::Ring;
+        else if (key == "densidad") cfg.density = std::atof(value.c_str());
+        else if (key == "reparar") cfg.repair = (value == "si");
+        else if (key == "inicio") cfg.greedy_init = (value == "voraz");
+        else if (key == "objetivo") {
+            cfg.target_optimum = (value == "optimo");
+            if (!cfg.target_optimum) cfg.stop.target = std::atoll(value.c_str());
+        }
+        else if (key == "estancamiento") cfg.stop.stagnation = std::atoi(value.c_str());
+        else if (key == "limite") cfg.stop.deadline = std::atof(value.c_str());
+        else if (key == "evaluaciones") cfg.stop.max_evaluations = std::strtoull(value.c_str(), nullptr, 10);
+        else if (key == "exacto") {
+            if (value == "dp") cfg.exact_engine = ExactEngine::DP;
+            else if (value == "bb") cfg.exact_engine = ExactEngine::BranchAndBound;
+            else if (value == "mitm") cfg.exact_engine = ExactEngine::MeetInTheMiddle;
+            else if (value == "no") cfg.exact_engine = ExactEngine::None;
+            else cfg.exact_engine = ExactEngine::Auto;
+        }
+        else if (key == "semilla") cfg.seed = std::strtoull(value.c_str(), nullptr, 10);
+        else if (key == "restricciones") cfg.dimensions = std::max(1, std::atoi(value.c_str()));
+        else if (key == "instancia") cfg.instance_path = value;
+        else if (key == "cache") cfg.instance_cache = (value == "si");
+        else if (key == "lote") cfg.batch = (value == "si");
+        else if (key == "hilos_lote") cfg.batch_threads = std::max(1, std::atoi(value.c_str()));
+        else if (key == "memo") cfg.memo_bits = std::atoi(value.c_str());
+        else if (key == "tipo") {
+            if (!parseFamily(value, cfg.generator.family)) cfg.invalid_option = option;
+        }
+        else if (key == "rango") cfg.generator.range = std::max(1, std::atoi(value.c_str()));
+        else if (key == "capacidad") cfg.generator.capacity_ratio = std::atof(value.c_str());
+    }
+    return true;
+}
+
+// Con `instancia=archivo` la instancia se lee del archivo: n_items y las
+// restricciones salen de el, y un optimo publicado se usa como referencia en
+// lugar del solver exacto. Si no, se genera.
+bool buildInstance(SweepConfig& cfg, uint32_t index) {
+    double pa = 0.25;
+    double a = 1.0;
+
+    std::shared_ptr<const ItemStore> store;
+    if (!cfg.instance_path.empty()) {
+        InstanceData data;
+        std::string error;
+        auto start = std::chrono::steady_clock::now();
+        if (!loadInstance(cfg.instance_path, cfg.instance_cache, data, error)) {
+            std::cerr << "No se pudo cargar la instancia " << cfg.instance_path << ": " << error << std::endl;
+            return false;
+        }
+        cfg.n_items = static_cast<int>(data.values.size());
+        cfg.dimensions = static_cast<int>(data.capacities.size());
+        if (data.known_optimum >= 0) {
+            cfg.exact = ExactResult{};
+            cfg.exact.solved = true;
+            cfg.exact.value = data.known_optimum;
+            cfg.exact.engine = "archivo";
+        }
+        store = std::make_shared<const ItemStore>(std::move(data.values), data.weights, std::move(data.capacities));
+        std::cerr << "Instancia " << cfg.instance_path << ": " << cfg.n_items << " items, " << cfg.dimensions
+                  << " restricciones, cargada en "
+                  << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << " ms"
+                  << std::endl;
+    } else {
+        // La instancia de la linea `index` sale del flujo reservado (semilla, index, STREAM_INSTANCE)
+        store = generateStore(cfg.seed, index, cfg.generator, cfg.n_items, cfg.dimensions);
+    }
+
+    cfg.solver = std::make_unique<CuckooSearchKnapsack>(std::move(store), cfg.n_nests, cfg.max_iter, pa, a);
+    cfg.solver->setLevyMode(cfg.levy_mode);
+    cfg.solver->setInitialDensity(cfg.density);
+    cfg.solver->setRepair(cfg.repair);
+    cfg.solver->setGreedyInit(cfg.greedy_init);
+    cfg.solver->setBatch(cfg.batch && !cfg.island_mode, cfg.batch_threads);
+    cfg.solver->setMemo(cfg.memo_bits);
+    cfg.solver->setStopPolicy(cfg.stop);
+    cfg.solver->setSeed(cfg.seed, index);
+    return true;
+}
+
+void writeRow(std::ostream& out, const SweepConfig& cfg) {
+    const RunsSummary& summary = cfg.summary;
+    out << cfg.n_items << "," << cfg.n_nests << "," << cfg.max_iter << ","
+        << summary.best_value << "," << summary.time.mean() << "," << summary.time.stddev() << ","
+        << summary.time_to_best.mean() << "," << summary.hot_loop_allocations << "," << cfg.seed << ",";
+    // optimum y gap (relativo, del mejor fitness al optimo) quedan vacios sin solver exacto
+    if (cfg.exact.solved) {
+        double gap = (cfg.exact.value == 0) ? 0.0 : static_cast<double>(cfg.exact.value - summary.best_value) / cfg.exact.value;
+        out << cfg.exact.value << "," << gap;
+    } else {
+        out << ",";
+    }
+    // nodes_per_sec queda vacio si el solver no visito nodos (el incumbente
+    // voraz cerro la raiz, o el optimo salio del archivo)
+    out << "," << cfg.exact.engine << "," << cfg.exact.seconds << ",";
+    if (cfg.exact.nodes > 0 && cfg.exact.seconds > 0) out << cfg.exact.nodes / cfg.exact.seconds;
+    out << "," << summary.time_to_feasible.mean() << "," << summary.time_to_feasible.count() << ",";
+    if (cfg.exact.solved) out << summary.time_to_target.mean() << "," << summary.time_to_target.count();
+    else out << ",";
+    out << "," << summary.stop_iteration.mean() << ","
+        << summary.time.min() << "," << summary.time.percentile(0.50) << "," << summary.time.percentile(0.90) << ","
+        << summary.time.percentile(0.99) << "," << summary.time.max();
+    // Desglose por fase: segundos y eventos promedio por repeticion (vacios sin CSA_PERFILAR)
+    const double runs = static_cast<double>(std::max<unsigned long long>(1, summary.time.count()));
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        out << ",";
+        if (CSA_PERFILAR) out << summary.profile.seconds(static_cast<Phase>(p)) / runs;
+    }
+    const unsigned long long counters[] = {summary.profile.evaluations, summary.profile.accepted, summary.profile.improvements,
+                                           summary.profile.cache_hits, summary.profile.cache_misses, summary.profile.duplicates};
+    for (unsigned long long c : counters) {
+        out << ",";
+        if (CSA_PERFILAR) out << c / runs;
+    }
+    out << "\n";
+}
+
+// Cada par (linea, repeticion) es una tarea, y el optimo exacto de cada linea
+// otra (rep = -1). Se envian al pool primero los optimos (asi las repeticiones
+// rara vez esperan al optimo guardando su historial) y luego de mayor a menor
+// coste estimado (n_items * max_iter * n_nests); las filas se escriben en el
+// orden original en cuanto terminan todas las tareas de su linea y de las
+// anteriores.
+void runSweep(std::vector<SweepConfig>& configs, ThreadPool& pool, std::ostream& out) {
+    struct Task {
+        double cost;
+        int config;
+        int rep;
+    };
+    std::vector<Task> tasks;
+    for (int c = 0; c < static_cast<int>(configs.size()); ++c) {
+        SweepConfig& cfg = configs[c];
+        cfg.summary = RunsSummary();
+        cfg.remaining = cfg.repetitions;
+        if (cfg.exact.solved) {
+            // Optimo publicado en el archivo de la instancia: no hace falta el solver exacto
+            if (cfg.target_optimum) {
+                StopPolicy policy = cfg.solver->getStopPolicy();
+                policy.target = cfg.exact.value;
+                cfg.solver->setStopPolicy(policy);
+            }
+            cfg.summary.setOptimum(cfg.exact.value);
+        } else if (cfg.target_optimum) {
+            // Las repeticiones necesitan el optimo antes de empezar: se resuelve aqui
+            cfg.exact = solveExact(*cfg.solver->getStore(),
+                                   cfg.exact_engine == ExactEngine::None ? ExactEngine::Auto : cfg.exact_engine);
+            StopPolicy policy = cfg.solver->getStopPolicy();
+            if (cfg.exact.solved) policy.target = cfg.exact.value;
+            cfg.solver->setStopPolicy(policy);
+            cfg.summary.setOptimum(cfg.exact.solved ? cfg.exact.value : -1);
+        } else if (cfg.exact_engine != ExactEngine::None) {
+            cfg.summary.expectOptimum();
+            tasks.push_back({cfg.exactCost(), c, -1});
+            cfg.remaining++;
+        }
+        int per_worker = cfg.island_mode ? cfg.island.islands : 1;
+        cfg.solver->prepareWorkspaces(pool.size() * per_worker);
+        for (int rep = 0; rep < cfg.repetitions; ++rep) tasks.push_back({cfg.cost(), c, rep});
+    }
+    std::stable_sort(tasks.begin(), tasks.end(), [](const Task& a, const Task& b) {
+        if ((a.rep < 0) != (b.rep < 0)) return a.rep < 0;
+        return a.cost > b.cost;
+    });
+
+    std::mutex sweep_mutex;
+    size_t next_row = 0;
+    auto flushFinished = [&]() {
+        while (next_row < configs.size() && configs[next_row].remaining == 0) {
+            writeRow(out, configs[next_row]);
+            configs[next_row].solver.reset();
+            next_row++;
+        }
+        out.flush();
+    };
+    // Una tarea de `cfg` termino (con el mutex tomado). Tras la ultima, su
+    // solver (instancia y espacios de trabajo) se libera enseguida: una fila
+    // que espera a las anteriores solo guarda su resumen.
+    auto finishTask = [&](SweepConfig& cfg) {
+        if (--cfg.remaining > 0) return;
+        cfg.solver.reset();
+        flushFinished();
+    };
+    {
+        std::lock_guard<std::mutex> lock(sweep_mutex);
+        flushFinished();
+    }
+
+    for (const Task& task : tasks) {
+        pool.submit([&, task](int worker) {
+            SweepConfig& cfg = configs[task.config];
+            CuckooSearchKnapsack& solver = *cfg.solver;
+            if (task.rep < 0) {
+                ExactResult exact = solveExact(*solver.getStore(), cfg.exact_engine);
+                std::lock_guard<std::mutex> lock(sweep_mutex);
+                cfg.exact = std::move(exact);
+                cfg.summary.setOptimum(cfg.exact.solved ? cfg.exact.value : -1);
+                finishTask(cfg);
+                return;
+            }
+            RunResult r = cfg.island_mode ? solver.islandSearch(cfg.island, task.rep, worker * cfg.island.islands)
+                                          : solver.runOnce(solver.workspace(worker), task.rep);
+            std::lock_guard<std::mutex> lock(sweep_mutex);
+            cfg.summary.add(std::move(r));
+            finishTask(cfg);
+        });
+    }
+    pool.wait();
+}
+
+// ===================== Microbenchmarks =====================
+// Mide por separado los nucleos del bucle principal sobre instancias
+// generadas igual que en el barrido. Cada medicion calienta una vez y repite
+// lotes que duplican su numero de llamadas hasta superar `min_seconds`; se
+// reporta el ultimo lote. Las reservas se cuentan con el contador global.
+struct BenchOptions {
+    std::vector<int> items = {10, 30, 100, 1000, 10000, 100000};
+    std::vector<int> nests = {15, 50};
+    int dimensions = 1; // restricciones de las instancias
+    double min_seconds = 0.2;
+    uint64_t seed = 0;
+};
+
+struct BenchResult {
+    std::string kernel;
+    int n_items;
+    int n_nests;
+    unsigned long long calls;
+    double items_per_call; // items procesados por llamada (n_items por solucion tocada)
+    double seconds;
+    unsigned long long allocations;
+};
+
+// Evita que el compilador descarte el resultado de un nucleo
+static volatile uint64_t bench_sink = 0;
+
+template <typename Kernel>
+BenchResult measureKernel(const std::string& name, int n_items, int n_nests, double items_per_call,
+                          double min_seconds, Kernel&& kernel) {
+    kernel();
+    BenchResult result{name, n_items, n_nests, 0, items_per_call, 0.0, 0};
+    for (unsigned long long batch = 1;; batch *= 2) {
+        unsigned long long allocations_before = heap_allocations;
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned long long c = 0; c < batch; ++c) kernel();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.calls = batch;
+        result.seconds = seconds;
+        result.allocations = heap_allocations - allocations_before;
+        if (seconds >= min_seconds) return result;
+    }
+}
+
+// Nucleos por tamano: fitness completo e incremental, Levy denso y disperso
+// y solucion aleatoria (no dependen de n_nests: se miden con el primero);
+// reemplazo de peores nidos, iteracion completa y, en el modo por lotes,
+// evaluacion de los N candidatos y generacion completa (por cada n_nests); y los
+// solvers exactos que quepan (mitm es la enumeracion exhaustiva)
+std::vector<BenchResult> runBenchmarks(const BenchOptions& opt) {
+    std::vector<BenchResult> results;
+    auto report = [&](BenchResult r) {
+        std::cerr << std::setw(22) << std::left << r.kernel << std::right << " n_items=" << std::setw(6) << r.n_items
+                  << " n_nests=" << std::setw(3) << r.n_nests << "  " << std::setprecision(4)
+                  << r.seconds * 1e9 / r.calls << " ns/llamada" << std::endl;
+        results.push_back(std::move(r));
+    };
+
+    for (int n_items : opt.items) {
+        for (size_t t = 0; t < opt.nests.size(); ++t) {
+            const int n_nests = opt.nests[t];
+            SweepConfig cfg;
+            cfg.n_items = n_items;
+            cfg.n_nests = n_nests;
+            cfg.max_iter = 1;
+            cfg.repetitions = 1;
+            cfg.dimensions = opt.dimensions;
+            cfg.seed = opt.seed;
+            buildInstance(cfg, 0);
+            CuckooSearchKnapsack& solver = *cfg.solver;
+            SearchWorkspace& ws = solver.workspace(0);
+            ws.reseed(opt.seed, 0, 0);
+            long long best_fitness = solver.initPopulation(ws);
+            PopulationArena& arena = ws.arena;
+            const double n = n_items;
+            std::vector<long long> totals(opt.dimensions);
+
+            if (t == 0) {
+                report(measureKernel("fitness", n_items, n_nests, n, opt.min_seconds, [&]() {
+                    long long v;
+                    solver.accumulate(arena.nest(0), totals.data(), v);
+                    bench_sink += solver.fitnessFromTotals(totals.data(), v);
+                }));
+                solver.levyFlightInto(ws, arena.nest(0), arena.candidate());
+                report(measureKernel("fitness_delta", n_items, n_nests, n, opt.min_seconds, [&]() {
+                    long long v;
+                    solver.accumulateDelta(arena.nest(0), arena.weight(0), arena.value(0), arena.candidate(), totals.data(), v);
+                    bench_sink += solver.fitnessFromTotals(totals.data(), v);
+                }));
+                solver.setLevyMode(LevyMode::Dense);
+                report(measureKernel("levyFlight/denso", n_items, n_nests, n, opt.min_seconds, [&]() {
+                    solver.levyFlightInto(ws, arena.nest(0), arena.candidate());
+                    bench_sink += arena.candidate()[0];
+                }));
+                solver.setLevyMode(LevyMode::Sparse);
+                report(measureKernel("levyFlight/disperso", n_items, n_nests, n, opt.min_seconds, [&]() {
+                    solver.levyFlightInto(ws, arena.nest(0), arena.candidate());
+                    bench_sink += arena.candidate()[0];
+                }));
+                solver.setLevyMode(LevyMode::Dense);
+                report(measureKernel("generateRandomSolution", n_items, n_nests, n, opt.min_seconds, [&]() {
+                    solver.fillRandomSolution(ws, arena.candidate());
+                    bench_sink += arena.candidate()[0];
+                }));
+            }
+
+            const int k = solver.replacementsPerIteration();
+            report(measureKernel("replaceWorst", n_items, n_nests, n * k, opt.min_seconds, [&]() {
+                solver.replaceWorst(ws);
+            }));
+            report(measureKernel("cuckooIteration", n_items, n_nests, n * (1 + k), opt.min_seconds, [&]() {
+                solver.cuckooIteration(ws, best_fitness);
+            }));
+
+            // La misma iteracion con la cache de fitness (2^16 entradas)
+            solver.setMemo(16);
+            best_fitness = solver.initPopulation(ws);
+            report(measureKernel("cuckooIteration/memo", n_items, n_nests, n * (1 + k), opt.min_seconds, [&]() {
+                solver.cuckooIteration(ws, best_fitness);
+            }));
+            solver.setMemo(0);
+
+            // Modo por lotes en un solo hilo: evaluacion por bloques de los N
+            // candidatos y generacion completa
+            solver.setBatch(true, 1);
+            SearchWorkspace& batch_ws = solver.workspace(1);
+            batch_ws.reseed(opt.seed, 0, 1);
+            WorkerTeam& team = solver.batchTeam(batch_ws);
+            long long batch_best = solver.initPopulation(batch_ws, n_nests);
+            team.run();
+            report(measureKernel("evaluacionLote", n_items, n_nests, n * n_nests, opt.min_seconds, [&]() {
+                solver.evaluateCandidates(batch_ws.arena, 0, n_nests);
+                bench_sink += batch_ws.arena.candidateValue(0);
+            }));
+            report(measureKernel("generacionLote", n_items, n_nests, n * (n_nests + k), opt.min_seconds, [&]() {
+                solver.batchGeneration(batch_ws, batch_best, team);
+                batch_ws.team_generation++;
+            }));
+            solver.setBatch(false, 1);
+
+            if (t == 0) {
+                const ItemStore& items = *solver.getStore();
+                if (items.dimensions() == 1 && MeetInTheMiddleSolver::fits(items)) {
+                    report(measureKernel("exacto/mitm", n_items, n_nests, n, opt.min_seconds, [&]() {
+                        bench_sink += solveExact(items, ExactEngine::MeetInTheMiddle).value;
+                    }));
+                }
+                if (items.dimensions() == 1 && DPKnapsackSolver::fits(items)) {
+                    report(measureKernel("exacto/dp", n_items, n_nests, n, opt.min_seconds, [&]() {
+                        bench_sink += solveExact(items, ExactEngine::DP).value;
+                    }));
+                }
+            }
+        }
+    }
+    return results;
+}
+
+void writeBenchJson(std::ostream& out, const BenchOptions& opt, const std::vector<BenchResult>& results) {
+    // Kernel de Levy elegido en ejecucion en esta maquina
+    const char* levy_kernel = LevyKernel(1.5).usesAvx2() ? "avx2" : "escalar";
+    out << "{\n  \"seed\": " << opt.seed << ",\n  \"dimensions\": " << opt.dimensions << ",\n  \"levy_kernel\": \"" << levy_kernel
+        << "\",\n  \"min_seconds\": " << opt.min_seconds << ",\n  \"results\": [";
+    for (size_t r = 0; r < results.size(); ++r) {
+        const BenchResult& b = results[r];
+        double ns_per_call = b.seconds * 1e9 / b.calls;
+        out << (r ? "," : "") << "\n    {\"kernel\": \"" << b.kernel << "\", \"n_items\": " << b.n_items
+            << ", \"n_nests\": " << b.n_nests << ", \"calls\": " << b.calls << ", \"seconds\": " << b.seconds
+            << ", \"ns_per_call\": " << ns_per_call << ", \"ns_per_item\": " << ns_per_call / b.items_per_call
+            << ", \"items_per_sec\": " << b.items_per_call * b.calls / b.seconds
+            << ", \"allocs_per_call\": " << static_cast<double>(b.allocations) / b.calls << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+// "10,100,1000" -> {10, 100, 1000}
+std::vector<int> parseIntList(const std::string& text) {
+    std::vector<int> values;
+    std::istringstream iss(text);
+    std::string token;
+    while (std::getline(iss, token, ',')) {
+        if (std::atoi(token.c_str()) > 0) values.push_back(std::atoi(token.c_str()));
+    }
+    return values;
+}
+
+int main(int argc, char** argv) {
+    // Numero de hilos del pool: --hilos=N (por defecto, todos los nucleos).
+    // Semilla global: --semilla=S (por defecto, aleatoria; queda en el CSV).
+    // Telemetria: --telemetria=archivo(.csv|.bin) y --muestreo=mejoras|log
+    // Microbenchmarks: --bench[=archivo.json] (por defecto bench.json), con
+    // --bench-items=10,100,... --bench-nidos=15,50 --bench-tiempo=S --bench-restricciones=D
+    // Generador: --generar=archivo.csai escribe una instancia por bloques, con
+    // --generar-items=N --generar-tipo=T --generar-rango=R --generar-capacidad=r --generar-restricciones=D
+    int n_threads = static_cast<int>(std::thread::hardware_concurrency());
+    std::string telemetry_path;
+    TelemetryMode telemetry_mode = TelemetryMode::Improvements;
+    uint64_t seed = (static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}();
+    std::string bench_path;
+    BenchOptions bench;
+    std::string generate_path;
+    GeneratorOptions generate;
+    size_t generate_items = 1000000;
+    int generate_dims = 1;
+    for (int k = 1; k < argc; ++k) {
+        std::string arg = argv[k];
+        if (arg.rfind("--hilos=", 0) == 0) n_threads = std::atoi(arg.c_str() + 8);
+        else if (arg.rfind("--semilla=", 0) == 0) seed = std::strtoull(arg.c_str() + 10, nullptr, 10);
+        else if (arg.rfind("--telemetria=", 0) == 0) telemetry_path = arg.substr(13);
+        else if (arg == "--muestreo=log") telemetry_mode = TelemetryMode::LogSpaced;
+        else if (arg == "--muestreo=mejoras") telemetry_mode = TelemetryMode::Improvements;
+        else if (arg == "--bench") bench_path = "bench.json";
+        else if (arg.rfind("--bench=", 0) == 0) bench_path = arg.substr(8);
+        else if (arg.rfind("--bench-items=", 0) == 0) bench.items = parseIntList(arg.substr(14));
+        else if (arg.rfind("--bench-nidos=", 0) == 0) bench.nests = parseIntList(arg.substr(14));
+        else if (arg.rfind("--bench-tiempo=", 0) == 0) bench.min_seconds = std::atof(arg.c_str() + 15);
+        else if (arg.rfind("--bench-restricciones=", 0) == 0) bench.dimensions = std::max(1, std::atoi(arg.c_str() + 22));
+        else if (arg.rfind("--generar=", 0) == 0) generate_path = arg.substr(10);
+        else if (arg.rfind("--generar-items=", 0) == 0) generate_items = std::strtoull(arg.c_str() + 16, nullptr, 10);
+        else if (arg.rfind("--generar-tipo=", 0) == 0) {
+            if (!parseFamily(arg.substr(15), generate.family)) {
+                std::cerr << "Familia desconocida: " << arg.substr(15) << std::endl;
+                return 1;
+            }
+        }
+        else if (arg.rfind("--generar-rango=", 0) == 0) generate.range = std::max(1, std::atoi(arg.c_str() + 16));
+        else if (arg.rfind("--generar-capacidad=", 0) == 0) generate.capacity_ratio = std::atof(arg.c_str() + 20);
+        else if (arg.rfind("--generar-restricciones=", 0) == 0) generate_dims = std::max(1, std::atoi(arg.c_str() + 24));
+    }
+    if (!generate_path.empty()) {
+        if (!writeGeneratedInstance(generate_path, seed, generate, generate_items, generate_dims)) {
+            std::cerr << "No se pudo escribir " << generate_path << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    if (!bench_path.empty()) {
+        bench.seed = seed;
+        std::vector<BenchResult> results = runBenchmarks(bench);
+        std::ofstream bench_out(bench_path);
+        writeBenchJson(bench_out, bench, results);
+        return bench_out ? 0 : 1;
+    }
+    std::unique_ptr<TelemetryWriter> telemetry;
+    if (!telemetry_path.empty()) {
+        telemetry = std::make_unique<TelemetryWriter>(telemetry_path);
+        if (!telemetry->ok()) {
+            std::cerr << "No se pudo abrir " << telemetry_path << std::endl;
+            return 1;
+        }
+    }
+    ThreadPool pool(std::max(1, n_threads));
+
+    std::ifstream config_file("config.txt");
+    std::vector<SweepConfig> configs;
+    std::string line;
+    while (std::getline(config_file, line)) {
+        if (line.empty()) continue;
+        SweepConfig cfg;
+        cfg.seed = seed;
+        if (!parseConfigLine(line, cfg)) continue;
+        if (!cfg.invalid_option.empty()) {
+            std::cerr << "Opcion no valida en config.txt: " << cfg.invalid_option << std::endl;
+            return 1;
+        }
+        configs.push_back(std::move(cfg));
+    }
+    for (size_t c = 0; c < configs.size(); ++c) {
+        if (!buildInstance(configs[c], static_cast<uint32_t>(c))) return 1;
+        if (telemetry) configs[c].solver->setTelemetry(telemetry.get(), telemetry_mode);
+    }
+
+    std::ofstream out("resultados.csv");
+    out << "n_items,n_nests,max_iter,best_fitness,avg_time,std_dev,avg_time_to_best,hot_allocs,seed,optimum,gap,exact_solver,exact_time,nodes_per_sec,"
+           "avg_time_to_feasible,feasible_runs,avg_time_to_1pct,runs_within_1pct,avg_stop_iter,"
+           "time_min,time_p50,time_p90,time_p99,time_max,"
+           "init_time,levy_time,eval_time,select_time,replace_time,migrate_time,avg_evaluations,avg_accepted,avg_improvements,"
+           "avg_cache_hits,avg_cache_misses,avg_duplicates\n";
+    runSweep(configs, pool, out);
 
     out.close();
     return 0;
@@ -7,20 +7,286 @@
 #include <iomanip>
 #include <chrono>
 #include <tuple>
+#include <cstdint>
+#include <memory>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-struct Item {
-    int peso;
-    int valor;
+// Items de la instancia, guardados una sola vez como estructura de arreglos
+// y compartidos (inmutables) por todas las ejecuciones. Puede tener D
+// restricciones: una fila de pesos y una capacidad por recurso.
+class ItemStore {
+private:
+    std::vector<int> item_values;
+    std::vector<int> item_weights;      // D filas de n pesos seguidas
+    std::vector<long long> capacities;  // una por restriccion
+
+public:
+    ItemStore(std::vector<int> values, std::vector<int> weights, std::vector<long long> caps)
+        : item_values(std::move(values)), item_weights(std::move(weights)), capacities(std::move(caps)) {}
+
+    size_t size() const { return item_values.size(); }
+    int dimensions() const { return static_cast<int>(capacities.size()); }
+    int value(size_t i) const { return item_values[i]; }
+    int weight(size_t i, int d) const { return item_weights[d * item_values.size() + i]; }
+    long long capacity(int d) const { return capacities[d]; }
+
+    // Valor de una solucion si respeta las D capacidades, 0 si no. Una sola
+    // pasada por restriccion con acumuladores de 64 bits.
+    long long evaluate(const std::vector<int>& solution) const {
+        const size_t n = item_values.size();
+        long long total_value = 0;
+        for (size_t i = 0; i < n; ++i) total_value += solution[i] ? item_values[i] : 0;
+        for (int d = 0; d < dimensions(); ++d) {
+            const int* row = item_weights.data() + d * n;
+            long long total_weight = 0;
+            for (size_t i = 0; i < n; ++i) total_weight += solution[i] ? row[i] : 0;
+            if (total_weight > capacities[d]) return 0;
+        }
+        return total_value;
+    }
+};
+
+// Cache de fitness de tamano fijo con direccionamiento abierto, indexada por
+// un hash Zobrist de la solucion: una clave aleatoria por item y el hash es
+// la base XOR las claves de los items elegidos, asi se actualiza con un XOR
+// por bit que cambia. Cada entrada guarda el hash completo (0 es vacia) y el
+// fitness; se prueban FITNESS_CACHE_PROBES posiciones seguidas y, si estan
+// ocupadas, se sobrescribe la primera. Se comparte entre ejecuciones porque
+// el fitness de una solucion solo depende de la instancia.
+const int FITNESS_CACHE_PROBES = 4;
+
+class FitnessCache {
+private:
+    struct Entry {
+        uint64_t key;
+        int fitness;
+    };
+    std::vector<uint64_t> item_keys;
+    uint64_t base_key;
+    std::vector<Entry> slots;
+    size_t mask;
+
+public:
+    FitnessCache(size_t n_items, int bits) : item_keys(n_items), slots(size_t(1) << bits, Entry{0, 0}), mask(slots.size() - 1) {
+        std::mt19937_64 keys(0x5A0B1575u); // fijo: el hash no cambia el resultado
+        for (uint64_t& key : item_keys) key = keys();
+        base_key = keys();
+    }
+
+    uint64_t base() const { return base_key; }
+    uint64_t key(size_t i) const { return item_keys[i]; }
+
+    bool find(uint64_t h, int& fitness) const {
+        for (int p = 0; p < FITNESS_CACHE_PROBES; ++p) {
+            const Entry& e = slots[(h + p) & mask];
+            if (e.key == h) {
+                fitness = e.fitness;
+                return true;
+            }
+            if (e.key == 0) return false;
+        }
+        return false;
+    }
+
+    void insert(uint64_t h, int fitness) {
+        for (int p = 0; p < FITNESS_CACHE_PROBES; ++p) {
+            Entry& e = slots[(h + p) & mask];
+            if (e.key == 0 || e.key == h) {
+                e = Entry{h, fitness};
+                return;
+            }
+        }
+        slots[h & mask] = Entry{h, fitness};
+    }
+};
+
+// Estadisticas en linea de memoria acotada: media y varianza de Welford,
+// minimo, maximo y percentiles de un histograma log-lineal al estilo HDR.
+// Cada valor se cuenta en unidades de `resolution` (1 ns para tiempos);
+// por debajo de 2^8 unidades los cubos son exactos y por encima cada
+// potencia de dos se divide en 128 cubos, asi el error relativo de un
+// percentil es menor que 1/128. El histograma crece solo hasta el mayor
+// cubo usado (unos 3500 cubos para un minuto en ns).
+class RunningStats {
+private:
+    static const int SUB_BITS = 8;
+    static const uint64_t HALF = 1ULL << (SUB_BITS - 1);
+    double resolution;
+    unsigned long long n = 0;
+    double mean_ = 0.0, m2 = 0.0;
+    double min_ = 0.0, max_ = 0.0;
+    std::vector<unsigned long long> buckets;
+
+    static size_t bucketOf(uint64_t ticks) {
+        if (ticks < (1ULL << SUB_BITS)) return static_cast<size_t>(ticks);
+        int msb = 63 - leadingZeros(ticks);
+        int shift = msb - (SUB_BITS - 1);
+        return static_cast<size_t>(shift * HALF + (ticks >> shift));
+    }
+
+    // Punto medio del cubo, en unidades
+    static double bucketValue(size_t idx) {
+        if (idx < (1ULL << SUB_BITS)) return static_cast<double>(idx);
+        uint64_t shift = idx / HALF - 1;
+        uint64_t sub = idx - shift * HALF;
+        return std::ldexp(static_cast<double>(sub), static_cast<int>(shift)) + (std::ldexp(1.0, static_cast<int>(shift)) - 1) / 2;
+    }
+
+    // Ceros a la izquierda de w (w != 0)
+    static int leadingZeros(uint64_t w) {
+#if defined(_MSC_VER)
+        unsigned long idx;
+        _BitScanReverse64(&idx, w);
+        return 63 - static_cast<int>(idx);
+#else
+        return __builtin_clzll(w);
+#endif
+    }
+
+public:
+    explicit RunningStats(double resolution = 1.0) : resolution(resolution) {}
+
+    void add(double x) {
+        n++;
+        double delta = x - mean_;
+        mean_ += delta / n;
+        m2 += delta * (x - mean_);
+        if (n == 1 || x < min_) min_ = x;
+        if (n == 1 || x > max_) max_ = x;
+        double scaled = std::max(0.0, x / resolution);
+        uint64_t ticks = scaled >= 9.2e18 ? (1ULL << 63) : static_cast<uint64_t>(std::llround(scaled));
+        size_t idx = bucketOf(ticks);
+        if (idx >= buckets.size()) buckets.resize(idx + 1, 0);
+        buckets[idx]++;
+    }
+
+    unsigned long long count() const { return n; }
+    double mean() const { return mean_; }
+    // Varianza poblacional (divide por n, como el calculo original)
+    double variance() const { return n ? m2 / n : 0.0; }
+    double stddev() const { return std::sqrt(variance()); }
+    double min() const { return min_; }
+    double max() const { return max_; }
+
+    // Percentil q en [0, 1] (menor valor con al menos q * n muestras <= el)
+    double percentile(double q) const {
+        if (n == 0) return 0.0;
+        unsigned long long rank = static_cast<unsigned long long>(std::ceil(q * n));
+        rank = std::max(1ULL, std::min(rank, n));
+        unsigned long long seen = 0;
+        for (size_t idx = 0; idx < buckets.size(); ++idx) {
+            seen += buckets[idx];
+            if (seen >= rank) {
+                double v = bucketValue(idx) * resolution;
+                return std::min(max_, std::max(min_, v));
+            }
+        }
+        return max_;
+    }
+};
+
+// Criterio de parada combinable; cada condicion desactivada (0, u objetivo
+// negativo) se ignora y max_iter sigue siendo el limite duro
+struct StopPolicy {
+    int target = -1;                          // fitness objetivo
+    int stagnation = 0;                       // iteraciones seguidas sin mejora
+    double deadline = 0.0;                    // segundos de pared desde el inicio
+    unsigned long long max_evaluations = 0;   // evaluaciones de fitness
+
+    bool shouldStop(int best_fitness, int since_improvement, double elapsed, unsigned long long evaluations) const {
+        return (target >= 0 && best_fitness >= target) || (stagnation > 0 && since_improvement >= stagnation) ||
+               (deadline > 0.0 && elapsed >= deadline) || (max_evaluations > 0 && evaluations >= max_evaluations);
+    }
+};
+
+// Perfilado por fases del bucle principal (se compila fuera con
+// -DCSA_PERFILAR=0). En x86 el reloj es el contador de ciclos; en otras
+// arquitecturas, steady_clock.
+#ifndef CSA_PERFILAR
+#define CSA_PERFILAR 1
+#endif
+
+enum Phase { PHASE_INIT, PHASE_LEVY, PHASE_EVAL, PHASE_SELECT, PHASE_REPLACE, PHASE_COUNT };
+
+inline uint64_t profileTicks() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Ticks por segundo, calibrados una vez contra steady_clock (~20 ms)
+inline double profileTicksPerSecond() {
+    static const double rate = []() {
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t c0 = profileTicks();
+        double elapsed = 0.0;
+        while (elapsed < 0.02) elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        return (profileTicks() - c0) / elapsed;
+    }();
+    return rate;
+}
+
+struct PhaseProfile {
+    uint64_t ticks[PHASE_COUNT] = {};
+    unsigned long long evaluations = 0;  // evaluaciones de fitness
+    unsigned long long accepted = 0;     // candidatos que reemplazaron a un nido
+    unsigned long long improvements = 0; // mejoras del mejor fitness
+    unsigned long long cache_hits = 0;   // fitness tomados de la cache
+    unsigned long long cache_misses = 0; // fitness calculados y guardados en la cache
+    unsigned long long duplicates = 0;   // candidatos iguales a un nido de la poblacion
+
+    void merge(const PhaseProfile& other) {
+        for (int p = 0; p < PHASE_COUNT; ++p) ticks[p] += other.ticks[p];
+        evaluations += other.evaluations;
+        accepted += other.accepted;
+        improvements += other.improvements;
+        cache_hits += other.cache_hits;
+        cache_misses += other.cache_misses;
+        duplicates += other.duplicates;
+    }
+    double seconds(Phase p) const { return ticks[p] / profileTicksPerSecond(); }
+};
+
+// Cronometro por vueltas: mark(fase) suma a esa fase el tiempo desde la marca anterior
+class PhaseLap {
+#if CSA_PERFILAR
+private:
+    PhaseProfile& profile;
+    uint64_t last;
+
+public:
+    explicit PhaseLap(PhaseProfile& p) : profile(p), last(profileTicks()) {}
+    void mark(Phase phase) {
+        uint64_t now = profileTicks();
+        profile.ticks[phase] += now - last;
+        last = now;
+    }
+#else
+public:
+    explicit PhaseLap(PhaseProfile&) {}
+    void mark(Phase) {}
+#endif
 };
 
+#if CSA_PERFILAR
+#define CSA_CONTAR(counter) (++(counter))
+#else
+#define CSA_CONTAR(counter) ((void)0)
+#endif
+
 class CuckooSearchKnapsack {
 private:
-    std::vector<Item> items;
-    int capacity;
+    std::shared_ptr<const ItemStore> items; // compartido, no se copia por ejecucion
     int n_nests;
     int max_iter;
     double pa;
@@ -29,33 +295,51 @@ private:
     std::uniform_real_distribution<> dis;
     std::uniform_int_distribution<> binary_dis;
     std::normal_distribution<> normal_dis;
+    PhaseProfile profile; // acumulado sobre las llamadas a cuckooSearch
+    FitnessCache* memo;   // opcional, propiedad del llamador
 
 public:
-    CuckooSearchKnapsack(const std::vector<Item>& items, int cap, int nests, int iterations, double prob_abandon, double a)
-        : items(items), capacity(cap), n_nests(nests), max_iter(iterations), pa(prob_abandon), alfa(a),
-          gen(std::random_device{}()), dis(0.0, 1.0), binary_dis(0, 1), normal_dis(0.0, 1.0) {}
+    CuckooSearchKnapsack(std::shared_ptr<const ItemStore> items, int nests, int iterations, double prob_abandon, double a)
+        : items(std::move(items)), n_nests(nests), max_iter(iterations), pa(prob_abandon), alfa(a),
+          gen(std::random_device{}()), dis(0.0, 1.0), binary_dis(0, 1), normal_dis(0.0, 1.0), memo(nullptr) {}
 
     int fitness(const std::vector<int>& solution) {
-        int total_weight = 0, total_value = 0;
-        for (size_t i = 0; i < solution.size(); ++i) {
-            if (solution[i] == 1) {
-                total_weight += items[i].peso;
-                total_value += items[i].valor;
-            }
+        return static_cast<int>(items->evaluate(solution));
+    }
+
+    // Con cache, el fitness de una solucion ya vista sale de su hash sin evaluarla
+    void setMemo(FitnessCache* cache) { memo = cache; }
+
+    int fitness(const std::vector<int>& solution, uint64_t hash) {
+        if (!memo) return fitness(solution);
+        int value;
+        if (memo->find(hash, value)) {
+            CSA_CONTAR(profile.cache_hits);
+            return value;
         }
-        return (total_weight > capacity) ? 0 : total_value;
+        CSA_CONTAR(profile.cache_misses);
+        value = fitness(solution);
+        memo->insert(hash, value);
+        return value;
     }
 
-    std::vector<int> generateRandomSolution() {
-        std::vector<int> nest(items.size());
-        for (size_t i = 0; i < items.size(); ++i) {
+    const PhaseProfile& getProfile() const { return profile; }
+
+    // Con cache, `hash` recibe el hash Zobrist de la solucion
+    std::vector<int> generateRandomSolution(uint64_t* hash = nullptr) {
+        std::vector<int> nest(items->size());
+        uint64_t h = memo ? memo->base() : 0;
+        for (size_t i = 0; i < items->size(); ++i) {
             nest[i] = binary_dis(gen);
+            if (memo && nest[i]) h ^= memo->key(i);
         }
+        if (hash) *hash = h;
         return nest;
     }
 
-    // Generar una solución mediante Levy flights
-    std::vector<int> levyFlight(const std::vector<int>& current_solution) {
+    // Generar una solución mediante Levy flights. Con cache, `hash` pasa del
+    // hash del padre al del hijo con un XOR por cada bit que cambia.
+    std::vector<int> levyFlight(const std::vector<int>& current_solution, uint64_t* hash = nullptr) {
         // Formular Levy Flight
         double beta = 1.5;
         double numerator = std::tgamma(1.0 + beta) * std::sin(M_PI * beta / 2.0);
@@ -73,18 +357,24 @@ public:
             double sigmoide = 1.0 / (1.0 + std::exp(-std::abs(new_value)));
             double r = dis(gen);
             new_solution[i] = (r < sigmoide) ? 1 : 0;
+            if (memo && hash && new_solution[i] != current_solution[i]) *hash ^= memo->key(i);
         }
         
         return new_solution;
     }
 
-    std::tuple<std::vector<int>, std::vector<int>, std::chrono::duration<double>> cuckooSearch() {
+    // Retorna la mejor solucion, la evolucion del fitness, el tiempo y la
+    // iteracion en la que se detuvo
+    std::tuple<std::vector<int>, std::vector<int>, std::chrono::duration<double>, int> cuckooSearch(const StopPolicy& stop = StopPolicy()) {
         auto start = std::chrono::high_resolution_clock::now();
+        PhaseLap lap(profile);
         std::vector<std::vector<int>> nests(n_nests);
         std::vector<int> fitness_values(n_nests);
+        std::vector<uint64_t> hashes(n_nests, 0); // solo con cache
         for (int i = 0; i < n_nests; ++i) {
-            nests[i] = generateRandomSolution();
-            fitness_values[i] = fitness(nests[i]);
+            nests[i] = generateRandomSolution(&hashes[i]);
+            fitness_values[i] = fitness(nests[i], hashes[i]);
+            CSA_CONTAR(profile.evaluations);
         }
 
         int best_idx = std::max_element(fitness_values.begin(), fitness_values.end()) - fitness_values.begin();
@@ -92,13 +382,27 @@ public:
         int best_fitness = fitness_values[best_idx];
         std::vector<int> fitness_evolution;
         fitness_evolution.push_back(best_fitness);
+        lap.mark(PHASE_INIT);
 
+        int num_replacements = static_cast<int>(pa * n_nests);
+        unsigned long long evaluations = n_nests;
+        int last_improvement = 0;
         int iteration = 0;
         while (iteration < max_iter) {
+            double elapsed = (stop.deadline > 0.0)
+                ? std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count() : 0.0;
+            if (stop.shouldStop(best_fitness, iteration - last_improvement, elapsed, evaluations)) break;
+            lap.mark(PHASE_SELECT);
+
             std::uniform_int_distribution<> nest_dis(0, n_nests - 1);
             int i = nest_dis(gen);
-            std::vector<int> new_nest = levyFlight(nests[i]);
-            int new_fitness = fitness(new_nest);
+            uint64_t new_hash = hashes[i];
+            std::vector<int> new_nest = levyFlight(nests[i], &new_hash);
+            lap.mark(PHASE_LEVY);
+            if (memo && std::find(hashes.begin(), hashes.end(), new_hash) != hashes.end()) CSA_CONTAR(profile.duplicates);
+            int new_fitness = fitness(new_nest, new_hash);
+            CSA_CONTAR(profile.evaluations);
+            lap.mark(PHASE_EVAL);
             int j;
             do {
                 j = nest_dis(gen);
@@ -107,40 +411,59 @@ public:
             if (new_fitness > fitness_values[j]) {
                 nests[j] = new_nest;
                 fitness_values[j] = new_fitness;
+                hashes[j] = new_hash;
+                CSA_CONTAR(profile.accepted);
             }
 
             int new_best_idx = std::max_element(fitness_values.begin(), fitness_values.end()) - fitness_values.begin();
             if (fitness_values[new_best_idx] > best_fitness) {
                 best_fitness = fitness_values[new_best_idx];
                 best_nest = nests[new_best_idx];
+                last_improvement = iteration + 1;
+                CSA_CONTAR(profile.improvements);
             }
+            lap.mark(PHASE_SELECT);
 
-            int num_replacements = static_cast<int>(pa * n_nests);
             std::vector<int> indices(n_nests);
             std::iota(indices.begin(), indices.end(), 0);
             std::sort(indices.begin(), indices.end(), [&](int a, int b) { return fitness_values[a] < fitness_values[b]; });
             for (int k = 0; k < num_replacements; ++k) {
                 int idx = indices[k];
-                nests[idx] = generateRandomSolution();
-                fitness_values[idx] = fitness(nests[idx]);
+                nests[idx] = generateRandomSolution(&hashes[idx]);
+                fitness_values[idx] = fitness(nests[idx], hashes[idx]);
+                CSA_CONTAR(profile.evaluations);
             }
 
+            evaluations += 1 + num_replacements;
             fitness_evolution.push_back(best_fitness);
             iteration++;
+            lap.mark(PHASE_REPLACE);
         }
 
         auto end = std::chrono::high_resolution_clock::now();
         std::chrono::duration<double> duration = end - start;
-        return {best_nest, fitness_evolution, duration};
+        return {best_nest, fitness_evolution, duration, iteration};
     }
 };
 
+// Valor optimo exacto por programacion dinamica: O(n * capacidad) tiempo y
+// un solo vector rodante de capacidad + 1 enteros (solo una restriccion)
+int optimoExacto(const ItemStore& items) {
+    const int capacity = static_cast<int>(items.capacity(0));
+    std::vector<int> mejor(capacity + 1, 0);
+    for (size_t i = 0; i < items.size(); ++i) {
+        for (int c = capacity; c >= items.weight(i, 0); --c) {
+            mejor[c] = std::max(mejor[c], mejor[c - items.weight(i, 0)] + items.value(i));
+        }
+    }
+    return mejor[capacity];
+}
+
 int main() {
-    std::vector<Item> items = {
-        {7, 70}, {3, 40}, {5, 60}, {8, 80}, {4, 50},
-        {6, 55}, {10, 100}, {9, 90}, {2, 30}, {1, 20}
-    };
-    int capacity = 15;
+    auto items = std::make_shared<const ItemStore>(
+        std::vector<int>{70, 40, 60, 80, 50, 55, 100, 90, 30, 20},   // valores
+        std::vector<int>{7, 3, 5, 8, 4, 6, 10, 9, 2, 1},              // pesos
+        std::vector<long long>{15});                                   // capacidad
     int nests = 10;
     int maxGenerations = 1000;
     double pa = 0.25;
@@ -148,45 +471,89 @@ int main() {
 
     int count_optimal = 0;
     int count_non_optimal = 0;
-    std::vector<double> tiempos;
-    std::vector<int> mejores_fitness;
+    // Memoria constante sin importar el numero de ejecuciones
+    RunningStats tiempos(1e-9);
+    RunningStats mejores_fitness(1.0);
+    RunningStats iteraciones_parada(1.0);
+    PhaseProfile perfil;
 
     const int ejecuciones = 10000;
-    const int optimo_conocido = 200;
+    const int optimo_conocido = optimoExacto(*items);
+
+    // Cache de fitness compartida por todas las ejecuciones (2^bits_memo
+    // entradas; 0 la desactiva). Con 10 items hay solo 1024 soluciones.
+    const int bits_memo = 12;
+    std::unique_ptr<FitnessCache> memo;
+    if (bits_memo > 0) memo = std::make_unique<FitnessCache>(items->size(), bits_memo);
+
+    // Cada ejecucion se detiene al alcanzar el optimo (o en maxGenerations)
+    StopPolicy parada;
+    parada.target = optimo_conocido;
 
     for (int i = 0; i < ejecuciones; ++i) {
-        CuckooSearchKnapsack cuckoo(items, capacity, nests, maxGenerations, pa, a);
-        auto [best_solution, fitness_evolution, duration] = cuckoo.cuckooSearch();
+        CuckooSearchKnapsack cuckoo(items, nests, maxGenerations, pa, a);
+        cuckoo.setMemo(memo.get());
+        auto [best_solution, fitness_evolution, duration, iteracion_parada] = cuckoo.cuckooSearch(parada);
         int mejor = fitness_evolution.back();
-        mejores_fitness.push_back(mejor);
-        tiempos.push_back(duration.count());
+        mejores_fitness.add(mejor);
+        tiempos.add(duration.count());
+        iteraciones_parada.add(iteracion_parada);
+        perfil.merge(cuckoo.getProfile());
         if (mejor == optimo_conocido)
             count_optimal++;
         else
             count_non_optimal++;
     }
 
-    double sum = std::accumulate(tiempos.begin(), tiempos.end(), 0.0);
-    double mean = sum / tiempos.size();
-    double sq_sum = std::inner_product(tiempos.begin(), tiempos.end(), tiempos.begin(), 0.0);
-    double stddev = std::sqrt(sq_sum / tiempos.size() - mean * mean);
+    double mean = tiempos.mean();
+    double stddev = tiempos.stddev();
 
-    double avg_fitness = std::accumulate(mejores_fitness.begin(), mejores_fitness.end(), 0.0) / mejores_fitness.size();
-    double sq_fit = std::inner_product(mejores_fitness.begin(), mejores_fitness.end(), mejores_fitness.begin(), 0.0);
-    double stddev_fit = std::sqrt(sq_fit / mejores_fitness.size() - avg_fitness * avg_fitness);
+    double avg_fitness = mejores_fitness.mean();
+    double stddev_fit = mejores_fitness.stddev();
+
+    double avg_parada = iteraciones_parada.mean();
 
     double error_abs = std::abs(optimo_conocido - avg_fitness);
     double error_rel = (optimo_conocido == 0) ? 0 : (error_abs / optimo_conocido) * 100;
 
     std::cout << "\n======= RESULTADOS DE " << ejecuciones << " EJECUCIONES =======" << std::endl;
-    std::cout << "Tiempo promedio: " << mean << " segundos" << std::endl;
+    std::cout << "Tiempo promedio hasta la parada: " << mean << " segundos" << std::endl;
+    std::cout << "Iteracion promedio de parada: " << avg_parada << " (maximo " << maxGenerations << ")" << std::endl;
     std::cout << "Desviacion estandar (tiempo): " << stddev << " segundos" << std::endl;
+    std::cout << "Tiempo min / p50 / p90 / p99 / max: " << tiempos.min() << " / " << tiempos.percentile(0.50) << " / "
+              << tiempos.percentile(0.90) << " / " << tiempos.percentile(0.99) << " / " << tiempos.max() << " segundos" << std::endl;
     std::cout << "Fitness promedio: " << avg_fitness << std::endl;
     std::cout << "Desviacion estandar (fitness): " << stddev_fit << std::endl;
+    std::cout << "Fitness min / p50 / max: " << mejores_fitness.min() << " / " << mejores_fitness.percentile(0.50) << " / "
+              << mejores_fitness.max() << std::endl;
     std::cout << "Error absoluto respecto al optimo: " << error_abs << std::endl;
     std::cout << "Error relativo respecto al optimo: " << error_rel << "%" << std::endl;
     std::cout << "Cantidad veces que se alcanzo el optimo (" << optimo_conocido << "): " << count_optimal << "/" << ejecuciones << std::endl;
     std::cout << "Cantidad veces que NO se alcanzo el optimo: " << count_non_optimal << "/" << ejecuciones << std::endl;
 
+#if CSA_PERFILAR
+    // Desglose del tiempo de busqueda por fase (la comprobacion de parada cuenta como seleccion)
+    const char* fases[PHASE_COUNT] = {"Inicializacion", "Levy flight", "Evaluacion", "Seleccion y mejor", "Reemplazo de peores"};
+    double total_fases = 0.0;
+    for (int p = 0; p < PHASE_COUNT; ++p) total_fases += perfil.seconds(static_cast<Phase>(p));
+    std::cout << "\n======= DESGLOSE POR FASE (promedio por ejecucion) =======" << std::endl;
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        double t = perfil.seconds(static_cast<Phase>(p));
+        std::cout << std::setw(20) << std::left << fases[p] << std::right << t / ejecuciones << " segundos ("
+                  << std::fixed << std::setprecision(1) << (total_fases > 0 ? 100.0 * t / total_fases : 0.0) << "%)"
+                  << std::defaultfloat << std::setprecision(6) << std::endl;
+    }
+    std::cout << "Evaluaciones de fitness: " << static_cast<double>(perfil.evaluations) / ejecuciones << std::endl;
+    std::cout << "Reemplazos aceptados: " << static_cast<double>(perfil.accepted) / ejecuciones << std::endl;
+    std::cout << "Mejoras del mejor: " << static_cast<double>(perfil.improvements) / ejecuciones << std::endl;
+    if (memo) {
+        unsigned long long consultas = perfil.cache_hits + perfil.cache_misses;
+        std::cout << "Cache de fitness: " << perfil.cache_hits << " aciertos, " << perfil.cache_misses << " fallos ("
+                  << std::fixed << std::setprecision(1) << (consultas ? 100.0 * perfil.cache_hits / consultas : 0.0)
+                  << "% de aciertos)" << std::defaultfloat << std::setprecision(6) << std::endl;
+        std::cout << "Candidatos duplicados en la poblacion: " << static_cast<double>(perfil.duplicates) / ejecuciones << std::endl;
+    }
+#endif
+
     return 0;
 }